@@ -0,0 +1,1501 @@
+// A Bison parser, made by GNU Bison 3.8.2.
+
+// Skeleton implementation for Bison LALR(1) parsers in C++
+
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
+
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
+
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
+
+
+
+
+#include "parser.hpp"
+
+
+// Unqualified %code blocks.
+#line 29 "src/parser.yy"
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "jmme-scanner.hpp"
+#include "snippet.hpp"
+
+#undef yylex
+#define yylex scanner.yylex
+
+#line 59 "bin/parser.cpp"
+
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(msgid) msgid
+# endif
+#endif
+
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
+        }                                                               \
+    while (false)
+# endif
+
+
+// Enable debugging if requested.
+#if YYDEBUG
+
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+#line 4 "src/parser.yy"
+namespace JMMExplorer {
+#line 152 "bin/parser.cpp"
+
+  /// Build a parser object.
+  JMMEParser::JMMEParser (JMMEScanner& scanner_yyarg, Snippet& ctx_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
+#else
+    :
+#endif
+      scanner (scanner_yyarg),
+      ctx (ctx_yyarg)
+  {}
+
+  JMMEParser::~JMMEParser ()
+  {}
+
+  JMMEParser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+  // basic_symbol.
+  template <typename Base>
+  JMMEParser::basic_symbol<Base>::basic_symbol (const basic_symbol& that)
+    : Base (that)
+    , value ()
+    , location (that.location)
+  {
+    switch (this->kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.copy< AdditiveOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.copy< ArithmeticOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.copy< Ident > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.copy< IncdecOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.copy< LocalValue > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.copy< MultiplicativeOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.copy< uint32_t > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+  }
+
+
+
+
+  template <typename Base>
+  JMMEParser::symbol_kind_type
+  JMMEParser::basic_symbol<Base>::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+  template <typename Base>
+  bool
+  JMMEParser::basic_symbol<Base>::empty () const YY_NOEXCEPT
+  {
+    return this->kind () == symbol_kind::S_YYEMPTY;
+  }
+
+  template <typename Base>
+  void
+  JMMEParser::basic_symbol<Base>::move (basic_symbol& s)
+  {
+    super_type::move (s);
+    switch (this->kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.move< AdditiveOpType > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.move< ArithmeticOpType > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< Ident > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.move< IncdecOpType > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< LocalValue > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.move< MultiplicativeOpType > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.move< uint32_t > (YY_MOVE (s.value));
+        break;
+
+      default:
+        break;
+    }
+
+    location = YY_MOVE (s.location);
+  }
+
+  // by_kind.
+  JMMEParser::by_kind::by_kind () YY_NOEXCEPT
+    : kind_ (symbol_kind::S_YYEMPTY)
+  {}
+
+#if 201103L <= YY_CPLUSPLUS
+  JMMEParser::by_kind::by_kind (by_kind&& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {
+    that.clear ();
+  }
+#endif
+
+  JMMEParser::by_kind::by_kind (const by_kind& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {}
+
+  JMMEParser::by_kind::by_kind (token_kind_type t) YY_NOEXCEPT
+    : kind_ (yytranslate_ (t))
+  {}
+
+
+
+  void
+  JMMEParser::by_kind::clear () YY_NOEXCEPT
+  {
+    kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+  void
+  JMMEParser::by_kind::move (by_kind& that)
+  {
+    kind_ = that.kind_;
+    that.clear ();
+  }
+
+  JMMEParser::symbol_kind_type
+  JMMEParser::by_kind::kind () const YY_NOEXCEPT
+  {
+    return kind_;
+  }
+
+
+  JMMEParser::symbol_kind_type
+  JMMEParser::by_kind::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+
+  // by_state.
+  JMMEParser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  JMMEParser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  JMMEParser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  JMMEParser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  JMMEParser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  JMMEParser::symbol_kind_type
+  JMMEParser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  JMMEParser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  JMMEParser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.YY_MOVE_OR_COPY< AdditiveOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.YY_MOVE_OR_COPY< ArithmeticOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.YY_MOVE_OR_COPY< Ident > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.YY_MOVE_OR_COPY< IncdecOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.YY_MOVE_OR_COPY< LocalValue > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.YY_MOVE_OR_COPY< MultiplicativeOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.YY_MOVE_OR_COPY< uint32_t > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  JMMEParser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.move< AdditiveOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.move< ArithmeticOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< Ident > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.move< IncdecOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< LocalValue > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.move< MultiplicativeOpType > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.move< uint32_t > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  JMMEParser::stack_symbol_type&
+  JMMEParser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.copy< AdditiveOpType > (that.value);
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.copy< ArithmeticOpType > (that.value);
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.copy< Ident > (that.value);
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.copy< IncdecOpType > (that.value);
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.copy< LocalValue > (that.value);
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.copy< MultiplicativeOpType > (that.value);
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.copy< uint32_t > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  JMMEParser::stack_symbol_type&
+  JMMEParser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        value.move< AdditiveOpType > (that.value);
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        value.move< ArithmeticOpType > (that.value);
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< Ident > (that.value);
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        value.move< IncdecOpType > (that.value);
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< LocalValue > (that.value);
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        value.move< MultiplicativeOpType > (that.value);
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        value.move< uint32_t > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  JMMEParser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  JMMEParser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  JMMEParser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  JMMEParser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  JMMEParser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  JMMEParser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  JMMEParser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  JMMEParser::debug_level_type
+  JMMEParser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  JMMEParser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  JMMEParser::state_type
+  JMMEParser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  JMMEParser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  JMMEParser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  JMMEParser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  JMMEParser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
+
+
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
+
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
+
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
+
+    goto yybackup;
+
+
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
+
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location));
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
+
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        goto yydefault;
+      }
+
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        yyn = -yyn;
+        goto yyreduce;
+      }
+
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
+
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    goto yynewstate;
+
+
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
+
+
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_ADDITIVE_OP: // ADDITIVE_OP
+        yylhs.value.emplace< AdditiveOpType > ();
+        break;
+
+      case symbol_kind::S_ASSIGN_OP: // ASSIGN_OP
+        yylhs.value.emplace< ArithmeticOpType > ();
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        yylhs.value.emplace< Ident > ();
+        break;
+
+      case symbol_kind::S_INCDEC_OP: // INCDEC_OP
+        yylhs.value.emplace< IncdecOpType > ();
+        break;
+
+      case symbol_kind::S_and_expression: // and_expression
+      case symbol_kind::S_xor_expression: // xor_expression
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_prefix_expression: // prefix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        yylhs.value.emplace< LocalValue > ();
+        break;
+
+      case symbol_kind::S_MULTIPLICATIVE_OP: // MULTIPLICATIVE_OP
+        yylhs.value.emplace< MultiplicativeOpType > ();
+        break;
+
+      case symbol_kind::S_INTLIT: // INTLIT
+        yylhs.value.emplace< uint32_t > ();
+        break;
+
+      default:
+        break;
+    }
+
+
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
+
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 9: // static_call: IDENT LPAREN expression RPAREN SEMIC
+#line 83 "src/parser.yy"
+                                             { ctx.emit_static_call(yystack_[4].value.as < Ident > (), yystack_[2].value.as < LocalValue > (), yystack_[4].location); }
+#line 880 "bin/parser.cpp"
+    break;
+
+  case 10: // method_call: IDENT DOT IDENT LPAREN RPAREN SEMIC
+#line 87 "src/parser.yy"
+                                            { ctx.emit_method_call(yystack_[5].value.as < Ident > (), yystack_[3].value.as < Ident > (), yystack_[5].location); }
+#line 886 "bin/parser.cpp"
+    break;
+
+  case 11: // assignment_statement: IDENT ASSIGN expression SEMIC
+#line 91 "src/parser.yy"
+                                      { ctx.emit_write(yystack_[3].value.as < Ident > (), yystack_[1].value.as < LocalValue > (), yystack_[3].location); }
+#line 892 "bin/parser.cpp"
+    break;
+
+  case 12: // assignment_op_statement: IDENT ASSIGN_OP expression SEMIC
+#line 95 "src/parser.yy"
+                                         { ctx.emit_op_write(yystack_[3].value.as < Ident > (), yystack_[1].value.as < LocalValue > (), yystack_[2].value.as < ArithmeticOpType > (), yystack_[3].location); }
+#line 898 "bin/parser.cpp"
+    break;
+
+  case 13: // incdec_statement: IDENT INCDEC_OP SEMIC
+#line 99 "src/parser.yy"
+                              { ctx.emit_op_write(yystack_[2].value.as < Ident > (), LocalValue::from_literal(1), to_arithmetic_type(yystack_[1].value.as < IncdecOpType > ()), yystack_[2].location); }
+#line 904 "bin/parser.cpp"
+    break;
+
+  case 14: // and_expression: additive_expression
+#line 103 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 910 "bin/parser.cpp"
+    break;
+
+  case 15: // and_expression: and_expression AMPERSAND additive_expression
+#line 104 "src/parser.yy"
+                                                       { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(yystack_[2].value.as < LocalValue > (), yystack_[0].value.as < LocalValue > (), ArithmeticOpType::And, yystack_[2].location); }
+#line 916 "bin/parser.cpp"
+    break;
+
+  case 16: // xor_expression: and_expression
+#line 108 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 922 "bin/parser.cpp"
+    break;
+
+  case 17: // xor_expression: xor_expression CARET and_expression
+#line 109 "src/parser.yy"
+                                              { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(yystack_[2].value.as < LocalValue > (), yystack_[0].value.as < LocalValue > (), ArithmeticOpType::Xor, yystack_[2].location); }
+#line 928 "bin/parser.cpp"
+    break;
+
+  case 18: // expression: xor_expression
+#line 113 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 934 "bin/parser.cpp"
+    break;
+
+  case 19: // expression: expression PIPE xor_expression
+#line 114 "src/parser.yy"
+                                         { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(yystack_[2].value.as < LocalValue > (), yystack_[0].value.as < LocalValue > (), ArithmeticOpType::Or, yystack_[2].location); }
+#line 940 "bin/parser.cpp"
+    break;
+
+  case 20: // additive_expression: multiplicative_expression
+#line 118 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 946 "bin/parser.cpp"
+    break;
+
+  case 21: // additive_expression: additive_expression ADDITIVE_OP multiplicative_expression
+#line 119 "src/parser.yy"
+                                                                    { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(yystack_[2].value.as < LocalValue > (), yystack_[0].value.as < LocalValue > (), to_arithmetic_type(yystack_[1].value.as < AdditiveOpType > ()), yystack_[2].location); }
+#line 952 "bin/parser.cpp"
+    break;
+
+  case 22: // multiplicative_expression: prefix_expression
+#line 123 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 958 "bin/parser.cpp"
+    break;
+
+  case 23: // multiplicative_expression: multiplicative_expression MULTIPLICATIVE_OP primary_expression
+#line 124 "src/parser.yy"
+                                                                         { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(yystack_[2].value.as < LocalValue > (), yystack_[0].value.as < LocalValue > (), to_arithmetic_type(yystack_[1].value.as < MultiplicativeOpType > ()), yystack_[2].location); }
+#line 964 "bin/parser.cpp"
+    break;
+
+  case 24: // prefix_expression: primary_expression
+#line 128 "src/parser.yy"
+        { yylhs.value.as < LocalValue > () = yystack_[0].value.as < LocalValue > (); }
+#line 970 "bin/parser.cpp"
+    break;
+
+  case 25: // prefix_expression: ADDITIVE_OP prefix_expression
+#line 129 "src/parser.yy"
+                                        { yylhs.value.as < LocalValue > () = ctx.emit_arithmetic(LocalValue::from_literal(0), yystack_[0].value.as < LocalValue > (), to_arithmetic_type(yystack_[1].value.as < AdditiveOpType > ()), yystack_[1].location); }
+#line 976 "bin/parser.cpp"
+    break;
+
+  case 26: // primary_expression: INTLIT
+#line 132 "src/parser.yy"
+               { yylhs.value.as < LocalValue > () = LocalValue::from_literal(yystack_[0].value.as < uint32_t > ()); }
+#line 982 "bin/parser.cpp"
+    break;
+
+  case 27: // primary_expression: IDENT
+#line 133 "src/parser.yy"
+                { yylhs.value.as < LocalValue > () = ctx.emit_read(yystack_[0].value.as < Ident > (), yystack_[0].location); }
+#line 988 "bin/parser.cpp"
+    break;
+
+  case 28: // primary_expression: LPAREN expression RPAREN
+#line 134 "src/parser.yy"
+                                   { yylhs.value.as < LocalValue > () = yystack_[1].value.as < LocalValue > (); }
+#line 994 "bin/parser.cpp"
+    break;
+
+
+#line 998 "bin/parser.cpp"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
+    }
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
+      {
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
+          {
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
+
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
+
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
+    }
+    goto yynewstate;
+
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
+
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
+
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
+
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
+
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
+
+  void
+  JMMEParser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
+
+  const char *
+  JMMEParser::symbol_name (symbol_kind_type yysymbol)
+  {
+    static const char *const yy_sname[] =
+    {
+    "end of file", "error", "invalid token", "SEMIC", "IDENT", "INTLIT",
+  "ADDITIVE_OP", "MULTIPLICATIVE_OP", "INCDEC_OP", "LPAREN", "RPAREN",
+  "DOT", "ASSIGN", "ASSIGN_OP", "PIPE", "AMPERSAND", "CARET", "$accept",
+  "program", "statement", "static_call", "method_call",
+  "assignment_statement", "assignment_op_statement", "incdec_statement",
+  "and_expression", "xor_expression", "expression", "additive_expression",
+  "multiplicative_expression", "prefix_expression", "primary_expression", YY_NULLPTR
+    };
+    return yy_sname[yysymbol];
+  }
+
+
+
+  // JMMEParser::context.
+  JMMEParser::context::context (const JMMEParser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
+
+  int
+  JMMEParser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+    const int yyn = yypact_[+yyparser_.yystack_[0].state];
+    if (!yy_pact_value_is_default_ (yyn))
+      {
+        /* Start YYX at -YYN if negative to avoid negative indexes in
+           YYCHECK.  In other words, skip the first -YYN actions for
+           this state because they are default actions.  */
+        const int yyxbegin = yyn < 0 ? -yyn : 0;
+        // Stay within bounds of both yycheck and yytname.
+        const int yychecklim = yylast_ - yyn + 1;
+        const int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+        for (int yyx = yyxbegin; yyx < yyxend; ++yyx)
+          if (yycheck_[yyx + yyn] == yyx && yyx != symbol_kind::S_YYerror
+              && !yy_table_value_is_error_ (yytable_[yyx + yyn]))
+            {
+              if (!yyarg)
+                ++yycount;
+              else if (yycount == yyargn)
+                return 0;
+              else
+                yyarg[yycount++] = YY_CAST (symbol_kind_type, yyx);
+            }
+      }
+
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
+  }
+
+
+
+
+
+
+  int
+  JMMEParser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
+    /* There are many possibilities here to consider:
+       - If this state is a consistent state with a default action, then
+         the only way this function was invoked is if the default action
+         is an error action.  In that case, don't check for expected
+         tokens because there are none.
+       - The only way there can be no lookahead present (in yyla) is
+         if this state is a consistent state with a default action.
+         Thus, detecting the absence of a lookahead is sufficient to
+         determine that there is no unexpected or expected token to
+         report.  In that case, just report a simple "syntax error".
+       - Don't assume there isn't a lookahead just because this state is
+         a consistent state with a default action.  There might have
+         been a previous inconsistent state, consistent state with a
+         non-default action, or user semantic action that manipulated
+         yyla.  (However, yyla is currently not documented for users.)
+       - Of course, the expected token list depends on states to have
+         correct lookahead information, and it depends on the parser not
+         to perform extra reductions after fetching a lookahead from the
+         scanner and before detecting a syntax error.  Thus, state merging
+         (from LALR or IELR) and default reductions corrupt the expected
+         token list.  However, the list is correct for canonical LR with
+         one exception: it will still contain any token that will not be
+         accepted due to an error action in a later state.
+    */
+
+    if (!yyctx.lookahead ().empty ())
+      {
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
+      }
+    return 0;
+  }
+
+  // Generate an error message.
+  std::string
+  JMMEParser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
+
+    char const* yyformat = YY_NULLPTR;
+    switch (yycount)
+      {
+#define YYCASE_(N, S)                         \
+        case N:                               \
+          yyformat = S;                       \
+        break
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+      }
+
+    std::string yyres;
+    // Argument number.
+    std::ptrdiff_t yyi = 0;
+    for (char const* yyp = yyformat; *yyp; ++yyp)
+      if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
+        {
+          yyres += symbol_name (yyarg[yyi++]);
+          ++yyp;
+        }
+      else
+        yyres += *yyp;
+    return yyres;
+  }
+
+
+  const signed char JMMEParser::yypact_ninf_ = -12;
+
+  const signed char JMMEParser::yytable_ninf_ = -1;
+
+  const signed char
+  JMMEParser::yypact_[] =
+  {
+     -12,    21,   -12,     5,   -12,   -12,   -12,   -12,   -12,   -12,
+       4,     0,     6,     0,     0,   -12,   -12,   -12,     0,     0,
+      14,    -1,    12,    22,    23,   -12,   -12,    24,    -3,    -2,
+     -12,    13,     0,     0,    28,     0,     0,    15,    25,   -12,
+     -12,   -12,    22,    14,   -12,    -1,    23,   -12,    29,   -12
+  };
+
+  const signed char
+  JMMEParser::yydefact_[] =
+  {
+       2,     0,     1,     0,     3,     4,     5,     6,     7,     8,
+       0,     0,     0,     0,     0,    13,    27,    26,     0,     0,
+      16,    18,     0,    14,    20,    22,    24,     0,     0,     0,
+      25,     0,     0,     0,     0,     0,     0,     0,     0,    11,
+      12,    28,    15,    17,     9,    19,    21,    23,     0,    10
+  };
+
+  const signed char
+  JMMEParser::yypgoto_[] =
+  {
+     -12,   -12,   -12,   -12,   -12,   -12,   -12,   -12,     1,     2,
+     -11,     7,     8,    18,     3
+  };
+
+  const signed char
+  JMMEParser::yydefgoto_[] =
+  {
+       0,     1,     4,     5,     6,     7,     8,     9,    20,    21,
+      22,    23,    24,    25,    26
+  };
+
+  const signed char
+  JMMEParser::yytable_[] =
+  {
+      39,    40,    28,    29,    16,    17,    18,    15,    31,    19,
+      27,    35,    35,    10,    11,    33,    12,    13,    14,    16,
+      17,     2,    34,    41,    19,     3,    35,    35,    36,    32,
+      37,    44,    49,    38,    43,    48,    30,    45,     0,    42,
+      47,     0,     0,     0,    46
+  };
+
+  const signed char
+  JMMEParser::yycheck_[] =
+  {
+       3,     3,    13,    14,     4,     5,     6,     3,    19,     9,
+       4,    14,    14,     8,     9,    16,    11,    12,    13,     4,
+       5,     0,    10,    10,     9,     4,    14,    14,     6,    15,
+       7,     3,     3,     9,    33,    10,    18,    35,    -1,    32,
+      37,    -1,    -1,    -1,    36
+  };
+
+  const signed char
+  JMMEParser::yystos_[] =
+  {
+       0,    18,     0,     4,    19,    20,    21,    22,    23,    24,
+       8,     9,    11,    12,    13,     3,     4,     5,     6,     9,
+      25,    26,    27,    28,    29,    30,    31,     4,    27,    27,
+      30,    27,    15,    16,    10,    14,     6,     7,     9,     3,
+       3,    10,    28,    25,     3,    26,    29,    31,    10,     3
+  };
+
+  const signed char
+  JMMEParser::yyr1_[] =
+  {
+       0,    17,    18,    18,    19,    19,    19,    19,    19,    20,
+      21,    22,    23,    24,    25,    25,    26,    26,    27,    27,
+      28,    28,    29,    29,    30,    30,    31,    31,    31
+  };
+
+  const signed char
+  JMMEParser::yyr2_[] =
+  {
+       0,     2,     0,     2,     1,     1,     1,     1,     1,     5,
+       6,     4,     4,     3,     1,     3,     1,     3,     1,     3,
+       1,     3,     1,     3,     1,     2,     1,     1,     3
+  };
+
+
+
+
+#if YYDEBUG
+  const unsigned char
+  JMMEParser::yyrline_[] =
+  {
+       0,    70,    70,    71,    75,    76,    77,    78,    79,    83,
+      87,    91,    95,    99,   103,   104,   108,   109,   113,   114,
+     118,   119,   123,   124,   128,   129,   132,   133,   134
+  };
+
+  void
+  JMMEParser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  JMMEParser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+  JMMEParser::symbol_kind_type
+  JMMEParser::yytranslate_ (int t) YY_NOEXCEPT
+  {
+    // YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to
+    // TOKEN-NUM as returned by yylex.
+    static
+    const signed char
+    translate_table[] =
+    {
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16
+    };
+    // Last valid token kind.
+    const int code_max = 271;
+
+    if (t <= 0)
+      return symbol_kind::S_YYEOF;
+    else if (t <= code_max)
+      return static_cast <symbol_kind_type> (translate_table[t]);
+    else
+      return symbol_kind::S_YYUNDEF;
+  }
+
+#line 4 "src/parser.yy"
+} // JMMExplorer
+#line 1494 "bin/parser.cpp"
+
+#line 138 "src/parser.yy"
+
+
+void JMMExplorer::JMMEParser::error(const location_type& loc, const std::string& msg)
+{
+	scanner.get_err_out() << "Parser error: " << msg << " at " << loc << '\n';
+}
@@ -1,11 +1,26 @@
 #include "analysis.hpp"
 
 #include <algorithm>
+#include <bitset>
 #include <cassert>
+#include <chrono>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
 
+#include "batch-evaluator.hpp"
+#include "engine-kernels.hpp"
+#include "interleaving-explorer.hpp"
 #include "jmme-scanner.hpp"
+#include "parallel.hpp"
 #include "parser.hpp"
+#include "result-store.hpp"
 #include "snippet.hpp"
 
 namespace JMMExplorer
@@ -52,12 +67,67 @@ void ExecutionResult::print(std::ostream& os, const std::function<std::string(ui
 	}
 }
 
-/// Returns true and prints error messages to err_out if and only if at least one of the snippets doesn't have monitor locks and unlocks correctly paired
-/// (given a particular snippet, the locks and unlocks are correctly paired if and only if for every monitor, the number of already performed locks is
+/// Returns true and prints error messages to err_out if and only if the snippet doesn't have monitor locks and unlocks correctly paired
+/// (the locks and unlocks are correctly paired if and only if for every monitor, the number of already performed locks is
 /// greater than or equal to the number of already performed unlocks at all times and these two numbers are equal at the end of the snippet)
-static bool check_monitor_use(const vec<Snippet>& snps, std::ostream& err_out)
+static bool check_monitor_use(const Snippet& snp, std::ostream& err_out)
 {
 	bool ret = false;
+	std::unordered_map<Ident, uint32_t> locked;
+	for (uint32_t i = 0; i < snp.action_count(); i++)
+	{
+		const Instruction& action = snp.get_action(i);
+		if (action.is_lock())
+			locked[action.get_monitor_name()]++;
+		else if (action.is_unlock())
+		{
+			const Ident mname = action.get_monitor_name();
+			if (locked[mname] == 0)
+			{
+				err_out << "Error: Unlocking monitor " << mname << " in " << snp.get_name() << " at " << action.location << std::endl;
+				ret = true;
+			}
+			else
+				locked[mname]--;
+		}
+	}
+	return ret;
+}
+
+/// Returns the names of the monitors and volatile variables of snps whose synchronization actions can't synchronize different threads: the monitors used
+/// by a single thread and the volatile variables used by a single thread, never written or never read (the volatile reads of such a variable see the last
+/// write of their own thread or the initial value wherever the actions of the variable are placed in the synchronization order, as long as it agrees
+/// with the program order)
+static std::unordered_set<Ident> find_inert_objects(const vec<Snippet>& snps)
+{
+	// for each monitor and volatile variable, the threads that use it and whether it is read and written
+	struct ObjectUse
+	{
+		std::unordered_set<uint32_t> threads;
+		bool read = false, written = false;
+	};
+	std::unordered_map<Ident, ObjectUse> uses;
+	for (uint32_t i = 0; i < snps.size(); i++)
+		for (const uint32_t k : snps[i].get_synchronization_actions())
+		{
+			const Instruction& action = snps[i].get_action(k);
+			ObjectUse& use = uses[action.is_lock() || action.is_unlock() ? action.get_monitor_name() : action.get_volatile_name()];
+			use.threads.insert(i);
+			use.read |= action.is_volatile_read();
+			use.written |= action.is_volatile_write();
+		}
+
+	std::unordered_set<Ident> inert;
+	for (const pair<const Ident, ObjectUse>& use : uses)
+		if (use.second.threads.size() == 1 || use.second.read != use.second.written)
+			inert.insert(use.first);
+	return inert;
+}
+
+/// Returns for every volatile variable used in snps the monitors that the accessing thread holds at every access to it
+static std::unordered_map<Ident, vec<Ident>> find_guarding_monitors(const vec<Snippet>& snps)
+{
+	std::unordered_map<Ident, vec<Ident>> guards;
 	for (const Snippet& snp : snps)
 	{
 		std::unordered_map<Ident, uint32_t> locked;
@@ -67,53 +137,674 @@ static bool check_monitor_use(const vec<Snippet>& snps, std::ostream& err_out)
 			if (action.is_lock())
 				locked[action.get_monitor_name()]++;
 			else if (action.is_unlock())
+				locked[action.get_monitor_name()]--;
+			else if (action.is_volatile_read() || action.is_volatile_write())
 			{
-				const Ident mname = action.get_monitor_name();
-				if (locked[mname] == 0)
-				{
-					err_out << "Error: Unlocking monitor " << mname << " in " << snp.get_name() << " at " << action.location << std::endl;
-					ret = true;
-				}
-				else
-					locked[mname]--;
+				vec<Ident> held;
+				for (const pair<const Ident, uint32_t>& monitor : locked)
+					if (monitor.second)
+						held.push_back(monitor.first);
+				const auto [it, first_access] = guards.emplace(action.get_volatile_name(), held);
+				if (!first_access)
+					it->second.erase(std::remove_if(it->second.begin(), it->second.end(), [&held](const Ident& mname)
+						{ return std::find(held.begin(), held.end(), mname) == held.end(); }), it->second.end());
 			}
 		}
 	}
-	return ret;
+	return guards;
 }
 
-/// Simulates the execution of the program given a particular write-seen function (it either produces the corresponding output or,
-/// if the write-seen function forms a dependency cycle, returns without producing any output)
-static void analyze_fixed_write_seen(vec<Snippet>& snps, const uint32_t globc, const vec<vec<uint32_t>>& to_glob_action, const vec<std::pair<uint32_t, uint32_t>>& to_thread_action, const std::function<const Instruction&(uint32_t)>& get_action, const std::unordered_map<uint32_t,uint32_t>& gintr_to_rix, const vec<int32_t>& write_seen, const vec<uint32_t>& reads, vec<ExecutionResult>& results)
+/// Splits the synchronization actions of snp (given by their action indices in synactions) into the units in which the synchronization orders are enumerated
+/// and returns the end of every unit (an index into synactions, the units follow each other); guards are the guarding monitors of the volatile variables
+/// (see find_guarding_monitors) and inert the objects whose actions don't have to be enumerated (see find_inert_objects)
+/// A critical section (from a lock of a monitor to the matching unlock) whose other synchronization actions are locks and unlocks
+/// of the same monitor and accesses to volatile variables guarded by it is a single unit, every other synchronization action is a unit of its own:
+/// no other thread can use any object of the section during it, so the actions of other threads in the middle of it can be moved after it without changing
+/// the order of the actions on any object (which is all that the happens-before order and the values seen by the volatile reads depend on)
+/// The actions on inert objects are added to the preceding unit of the thread; the number of the ones before the first unit is stored into prefix
+static vec<uint32_t> find_so_units(const Snippet& snp, const vec<uint32_t>& synactions, const std::unordered_map<Ident, vec<Ident>>& guards,
+	const std::unordered_set<Ident>& inert, uint32_t& prefix)
 {
-	for (Snippet& snp : snps)
-		snp.prepare_execution();
+	const auto is_inert = [&inert](const Instruction& action)
+	{
+		return inert.count(action.is_lock() || action.is_unlock() ? action.get_monitor_name() : action.get_volatile_name()) != 0;
+	};
+	const auto is_guarded_by = [&guards, &is_inert](const Instruction& action, const Ident& mname)
+	{
+		if (is_inert(action))
+			return true;
+		if (action.is_lock() || action.is_unlock())
+			return action.get_monitor_name() == mname;
+		const vec<Ident>& monitors = guards.at(action.get_volatile_name());
+		return std::find(monitors.begin(), monitors.end(), mname) != monitors.end();
+	};
+
+	vec<uint32_t> unit_ends;
+	prefix = synactions.size();
+	for (uint32_t k = 0; k < synactions.size(); k++)
+	{
+		const Instruction& action = snp.get_action(synactions[k]);
+		if (is_inert(action))
+		{
+			if (!unit_ends.empty())
+				unit_ends.back() = k + 1;
+			continue;
+		}
+		if (unit_ends.empty())
+			prefix = k;
+		if (action.is_lock())
+		{
+			const Ident mname = action.get_monitor_name();
+			uint32_t depth = 1;
+			uint32_t e = k + 1;
+			for (; e < synactions.size() && depth; e++)
+			{
+				const Instruction& inner = snp.get_action(synactions[e]);
+				if (!is_guarded_by(inner, mname))
+					break;
+				if (inner.is_lock() && inner.get_monitor_name() == mname)
+					depth++;
+				else if (inner.is_unlock() && inner.get_monitor_name() == mname)
+					depth--;
+			}
+			if (!depth)
+				k = e - 1;
+		}
+		unit_ends.push_back(k + 1);
+	}
+	return unit_ends;
+}
+
+/// Parses source into snp, writing the error messages to err_out
+static void parse_snippet(const std::string_view source, Snippet& snp, std::ostream& err_out)
+{
+	JMMEScanner scn(source, err_out);
+	JMMEParser prs(scn, snp);
+	prs();
+}
+
+/// Reads the whole contents of every input
+static vec<str> read_inputs(const vec<std::istream*>& inputs)
+{
+	vec<str> contents;
+	for (std::istream *const input : inputs)
+		contents.emplace_back(std::istreambuf_iterator<char>(*input), std::istreambuf_iterator<char>());
+	return contents;
+}
+
+void parse_snippets(const vec<std::string>& filenames, const vec<std::string_view>& sources, vec<Snippet>& snps)
+{
+	const uint32_t first = snps.size();
+	for (uint32_t i = 0; i < sources.size(); i++)
+		snps.push_back(Snippet(filenames[i]));
+
+	// the files are parsed in parallel, each one with its own stream for the error messages, which are printed in the order of the files afterwards
+	vec<std::ostringstream> diagnostics(sources.size());
+	parallel_for(sources.size(), [&](const uint32_t i){ parse_snippet(sources[i], snps[first + i], diagnostics[i]); });
+	for (const std::ostringstream& diag : diagnostics)
+		std::cerr << diag.str();
+}
+
+void parse_snippets(const vec<std::string>& filenames, const vec<std::istream*>& inputs, vec<Snippet>& snps)
+{
+	const vec<str> contents = read_inputs(inputs);
+	parse_snippets(filenames, vec<std::string_view>(contents.begin(), contents.end()), snps);
+}
+
+/// Returns the number of bytes of the memory allocated for the elements of v
+template<typename T>
+static uint64_t vec_memory_use(const vec<T>& v)
+{
+	return v.capacity() * sizeof(T);
+}
+
+/// Returns the number of bytes of the memory allocated for the elements of v and of its vectors (recursively)
+template<typename T>
+static uint64_t vec_memory_use(const vec<vec<T>>& v)
+{
+	uint64_t use = v.capacity() * sizeof(vec<T>);
+	for (const vec<T>& inner : v)
+		use += vec_memory_use(inner);
+	return use;
+}
+
+struct EngineWorker;
+
+/// The static description of a program (whose snippets have already had their preexecution analysis run) together with scratch buffers that are reused
+/// across all the synchronization orders and write-seen candidates tried, so that the search doesn't allocate memory once the buffers have grown to their final sizes
+struct EngineContext
+{
+	/// the snippets (threads) of the program
+	vec<Snippet>& snps;
+
+	/// receives every new execution result (can be empty)
+	const ResultSink& sink;
+
+	/// number of write-seen candidates that can still be evaluated (shared by all analyzed components)
+	uint64_t& candidates_left;
+
+	/// how the analysis ends; the enumeration continues only as long as this is AnalysisStatus::Completed
+	AnalysisStatus status = AnalysisStatus::Completed;
+
+	/// total number of actions
+	uint32_t globc = 0;
+
+	/// converts from the global indexing of actions to the per-thread indexing
+	vec<pair<uint32_t, uint32_t>> to_thread_action;
+
+	/// converts from the per-thread indexing of actions to the global indexing
+	vec<vec<uint32_t>> to_glob_action;
+
+	/// for each thread, holds the indices of all synchronization actions
+	vec<vec<uint32_t>> synactions;
+
+	/// total number of synchronization actions
+	uint32_t synaction_count = 0;
+
+	/// for each thread, the end of each of its units of the enumeration of the synchronization orders (see find_so_units)
+	vec<vec<uint32_t>> so_units;
+
+	/// for each thread, the number of its first synchronization actions that precede all its units (they are put at the start of every synchronization order)
+	vec<uint32_t> so_prefix;
+
+	/// total number of the units of the enumeration of the synchronization orders
+	uint32_t so_unit_count = 0;
+
+	/// for each global action index, the id of the variable or monitor accessed by the action (variables and monitors are numbered together)
+	vec<uint32_t> object_id;
+
+	/// number of distinct variables and monitors
+	uint32_t object_count = 0;
+
+	/// global action indices of all read actions
+	vec<uint32_t> reads;
+
+	/// map: global action index of a read action -> index of the read (-1 for actions that aren't reads)
+	vec<int32_t> gintr_to_rix;
+
+	/// global action indices of all shared (non-volatile) reads
+	vec<uint32_t> shared_reads;
+
+	/// for each shared read, its index among all reads
+	vec<uint32_t> shared_read_rix;
+
+	/// for each global action index, true iff the action is a read whose value can influence the execution result
+	vec<bool> relevant;
+
+	/// for each variable id and thread, the global indices of all the shared writes of the thread to the variable in the program order
+	vec<vec<vec<uint32_t>>> thread_writes;
+
+	/// for each thread, the number of synchronization actions of all threads with lower indices (the synchronization actions are numbered thread after thread)
+	vec<uint32_t> synaction_base;
+
+	/// for each global action index, the number of the last synchronization action of the same thread that isn't after the action in the program order (-1 if there is none)
+	vec<int32_t> last_synaction;
+
+	// scratch buffers of analyze_fixed_so
+
+	/// for each monitor id, the number of times it is held and by which thread
+	vec<uint32_t> hold_count, holding_thread;
+
+	/// vector clocks of the synchronization actions: value at index k * thread count + t is the number of actions of thread t that happen before or are
+	/// the synchronization action number k (every other action has the clock of the last synchronization action of its thread, except for its own thread)
+	vec<uint32_t> clocks;
+
+	/// for each volatile variable and monitor id, the join of the clocks of all the volatile writes to it or unlocks of it so far in the synchronization order (same layout as clocks)
+	vec<uint32_t> released;
+
+	/// for each shared read, the set of all writes that can be seen by it if compliant with HB
+	vec<vec<int32_t>> pss_write_seen;
+
+	/// for each thread with a write of the same variable that precedes the current read in HB, the last such write of the thread
+	vec<uint32_t> preceding_writes;
+
+	/// for each variable id, the global index of the last volatile write to it seen so far in the synchronization order (-1 for the initial write)
+	vec<int32_t> last_writer;
+
+	/// for each read, the global index of the write it sees (-1 for the initial write)
+	vec<int32_t> write_seen;
+
+	/// for each shared read, the index in pss_write_seen of the write currently seen
+	vec<uint32_t> write_seen_i;
+
+	// scratch buffers of analyze_fixed_write_seen
+
+	/// value at index i is the number of reads on which read i depends that have not yet been evaluated
+	vec<uint32_t> outstanding;
+
+	/// index i stores all reads that depend on read i
+	vec<vec<uint32_t>> used_by;
+
+	/// all reads that can be evaluated (because all their dependencies have already been evaluated)
+	vec<uint32_t> ready;
+
+	/// number of 64-bit words of the fixed-size sets of reads used by has_small_dependency_cycle (1, 2 or 4; 0 if there are too many reads for them)
+	uint32_t read_set_words = 0;
+
+	/// for each global action index of a write, the set of the reads (as bits at their indices) that the write depends on, read_set_words words per action
+	vec<uint64_t> write_read_deps;
+
+	/// for each snippet, the index of its first printed value in newout (with the total number of printed values at the end)
+	vec<uint32_t> print_offsets;
+
+	/// the values printed by all the snippets in the current execution, one snippet after another
+	vec<int32_t> newout;
+
+	// state of the incremental evaluation of write-seen candidates that differ from the previous one in a single read
+
+	/// true iff no snippet can cause an exception, so that candidates can be evaluated incrementally (which exception is reported
+	/// depends on the order in which a full evaluation visits the reads, which an incremental evaluation doesn't follow)
+	bool incremental = false;
 
-	// value at index i is the number of reads on which read i depends that have not yet been evaluated
-	vec<uint32_t> outstanding(reads.size());
+	/// true iff the last evaluated candidate had no dependency cycle and used_by and the values in the snippets correspond to it
+	bool incremental_valid = false;
 
-	// index i stores all reads that depend on read i
-	vec<vec<uint32_t>> used_by(reads.size());
+	/// for each read, the number of the last search of analyze_changed_read that has visited it
+	vec<uint32_t> visited_in;
 
-	uint32_t nr = 0;
+	/// number of the current search of analyze_changed_read
+	uint32_t visit_number = 0;
+
+	/// reads affected by the change of a single read in DFS postorder
+	vec<uint32_t> affected;
+
+	/// stack of the DFS of analyze_changed_read: pairs of a read and the next index in its used_by to visit
+	vec<pair<uint32_t, uint32_t>> dfs_stack;
+
+	/// for each shared read, the direction in which its index in write_seen_i moves in the Gray code order (true means increasing)
+	vec<bool> gray_ascending;
+
+	// batched evaluation of the candidates of programs that can cause an exception (so that they can't be evaluated incrementally)
+
+	/// evaluator of batches of candidates (only present if incremental is false)
+	std::optional<BatchEvaluator> batch;
+
+	/// number of candidates waiting in batch to be evaluated
+	uint32_t batch_size = 0;
+
+	/// number of the following candidates to be evaluated by analyze_fixed_write_seen directly (used while most of the batched candidates divide by zero,
+	/// since they have to be evaluated again anyway)
+	uint32_t unbatched_left = 0;
+
+	/// the value unbatched_left is set to after the next batch in which most candidates divide by zero (doubles with every such batch in a row)
+	uint32_t unbatched_run = BatchEvaluator::lane_count;
+
+	// parallel evaluation of the candidates of a synchronization order with many of them
+
+	/// number of threads that evaluate the candidates of such a synchronization order (1 means that they are evaluated by this context alone)
+	uint32_t worker_count = 1;
+
+	/// the states of those threads (created when they are needed for the first time)
+	vec<std::unique_ptr<EngineWorker>> workers;
+
+	/// approximate number of bytes that the context, its workers and the results of the analysis may use (0 means no limit, see AnalysisOptions::memory_limit)
+	uint64_t memory_limit = 0;
+
+	EngineContext(vec<Snippet>& snps, const ResultSink& sink, uint64_t& candidates_left);
+
+	/// Returns the approximate number of bytes of memory used by the tables and the buffers of the context (without its workers)
+	uint64_t memory_use() const;
+
+	/// Returns the action with the global index globi
+	const Instruction& get_action(uint32_t globi) const;
+	/// Returns true iff the action a happens before or is the action b (in the synchronization order whose clocks are stored in clocks);
+	/// ThreadCount is the number of threads if it is known at compile time, otherwise 0
+	template<uint32_t ThreadCount = 0>
+	bool happens_before(uint32_t a, uint32_t b) const;
+};
+
+/// The state of a thread that evaluates a part of the write-seen candidates of a synchronization order (see enumerate_write_seen_in_parallel)
+struct EngineWorker
+{
+	/// copies of the snippets of the program, so that the thread has its own execution state
+	vec<Snippet> snps;
+
+	/// the empty sink of ctx (the results are passed on only when they are merged)
+	ResultSink no_sink;
+
+	/// the part of the candidate budget given to the thread
+	uint64_t candidates_left = 0;
+
+	/// the search state of the thread (its synchronization order is copied from the context of the whole analysis)
+	EngineContext ctx;
+
+	/// the distinct results found by the thread in the current synchronization order
+	std::optional<ResultStore> results;
+
+	EngineWorker(const vec<Snippet>& snps);
+};
+
+EngineContext::EngineContext(vec<Snippet>& snps, const ResultSink& sink, uint64_t& candidates_left)
+	: snps(snps), sink(sink), candidates_left(candidates_left), to_glob_action(snps.size()), synactions(snps.size()), so_units(snps.size()), so_prefix(snps.size()), print_offsets(1, 0)
+{
+	for (const Snippet& snp : snps)
+		print_offsets.push_back(print_offsets.back() + snp.print_count());
+	newout.resize(print_offsets.back());
+
+	// populate to_thread_action and to_glob_action
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		const uint32_t action_count = snps[i].action_count();
+		for (uint32_t j = 0; j < action_count; j++)
+		{
+			to_thread_action.push_back({ i, j });
+			to_glob_action[i].push_back(globc++);
+		}
+	}
+
+	last_synaction.resize(globc);
+	const std::unordered_map<Ident, vec<Ident>> guards = find_guarding_monitors(snps);
+	const std::unordered_set<Ident> inert = find_inert_objects(snps);
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		synactions[i] = snps[i].get_synchronization_actions();
+		synaction_base.push_back(synaction_count);
+		int32_t last = -1;
+		for (uint32_t j = 0, k = 0; j < snps[i].action_count(); j++)
+		{
+			if (k < synactions[i].size() && synactions[i][k] == j)
+				last = synaction_count + k++;
+			last_synaction[to_glob_action[i][j]] = last;
+		}
+		synaction_count += synactions[i].size();
+		so_units[i] = find_so_units(snps[i], synactions[i], guards, inert, so_prefix[i]);
+		so_unit_count += so_units[i].size();
+	}
+
+	std::unordered_map<Ident, uint32_t> object_ids;
+	object_id.resize(globc);
+	gintr_to_rix.resize(globc, -1);
 	for (uint32_t i = 0; i < globc; i++)
 	{
 		const Instruction& action = get_action(i);
+		const Ident name = action.is_lock() || action.is_unlock() ? action.get_monitor_name()
+			: action.is_volatile_read() || action.is_volatile_write() ? action.get_volatile_name() : action.get_shared_name();
+		const auto it = object_ids.find(name);
+		object_id[i] = it != object_ids.end() ? it->second : object_ids[name] = object_count++;
 		if (action.is_read())
 		{
-			if (write_seen[nr] != -1)
+			gintr_to_rix[i] = reads.size();
+			reads.push_back(i);
+		}
+		if (action.is_shared_read())
+		{
+			shared_reads.push_back(i);
+			shared_read_rix.push_back(gintr_to_rix[i]);
+		}
+	}
+
+	thread_writes.assign(object_count, vec<vec<uint32_t>>(snps.size()));
+	for (uint32_t i = 0; i < globc; i++)
+		if (get_action(i).is_shared_write())
+			thread_writes[object_id[i]][to_thread_action[i].first].push_back(i);
+
+	hold_count.resize(object_count);
+	holding_thread.resize(object_count);
+	last_writer.resize(object_count);
+	clocks.resize(synaction_count * snps.size());
+	released.resize(object_count * snps.size());
+	pss_write_seen.resize(shared_reads.size());
+	write_seen.resize(reads.size());
+	write_seen_i.resize(shared_reads.size());
+	outstanding.resize(reads.size());
+	used_by.resize(reads.size());
+	for (const uint32_t words : { 1u, 2u, 4u })
+		if (reads.size() <= words * 64)
+		{
+			read_set_words = words;
+			break;
+		}
+	write_read_deps.resize(read_set_words * globc);
+	for (uint32_t i = 0; read_set_words && i < globc; i++)
+		if (get_action(i).is_write())
+		{
+			const pair<uint32_t, uint32_t> threada = to_thread_action[i];
+			for (const uint32_t dep : snps[threada.first].get_write_dependencies(threada.second))
 			{
-				const pair<uint32_t, uint32_t> wthreada = to_thread_action[write_seen[nr]];
-				const vec<uint32_t>& deps = snps[wthreada.first].get_write_dependencies(wthreada.second);
-				outstanding[nr] = deps.size();
-				for (const uint32_t dep : deps)
-					used_by[gintr_to_rix.at(to_glob_action[wthreada.first][dep])].push_back(nr);
+				const uint32_t rix = gintr_to_rix[to_glob_action[threada.first][dep]];
+				write_read_deps[i * read_set_words + rix / 64] |= uint64_t(1) << (rix % 64);
 			}
-			else
-				outstanding[nr] = 0;
-			nr++;
 		}
+	ready.reserve(reads.size());
+	visited_in.resize(reads.size(), 0);
+	gray_ascending.resize(shared_reads.size());
+	incremental = std::none_of(snps.begin(), snps.end(), [](const Snippet& snp){ return snp.may_throw(); });
+	if (!incremental)
+		batch.emplace(snps, to_thread_action, reads);
+}
+
+uint64_t EngineContext::memory_use() const
+{
+	return vec_memory_use(to_thread_action) + vec_memory_use(to_glob_action) + vec_memory_use(synactions) + vec_memory_use(so_units)
+		+ vec_memory_use(so_prefix) + vec_memory_use(object_id) + vec_memory_use(reads) + vec_memory_use(gintr_to_rix) + vec_memory_use(shared_reads)
+		+ vec_memory_use(shared_read_rix) + vec_memory_use(relevant) + vec_memory_use(thread_writes) + vec_memory_use(synaction_base)
+		+ vec_memory_use(last_synaction) + vec_memory_use(hold_count) + vec_memory_use(holding_thread) + vec_memory_use(clocks) + vec_memory_use(released)
+		+ vec_memory_use(pss_write_seen) + vec_memory_use(preceding_writes) + vec_memory_use(last_writer) + vec_memory_use(write_seen)
+		+ vec_memory_use(write_seen_i) + vec_memory_use(outstanding) + vec_memory_use(used_by) + vec_memory_use(ready) + vec_memory_use(write_read_deps)
+		+ vec_memory_use(print_offsets) + vec_memory_use(newout) + vec_memory_use(visited_in) + vec_memory_use(affected) + vec_memory_use(dfs_stack)
+		+ vec_memory_use(gray_ascending);
+}
+
+const Instruction& EngineContext::get_action(const uint32_t globi) const
+{
+	const pair<uint32_t, uint32_t> thread_action = to_thread_action[globi];
+	return snps[thread_action.first].get_action(thread_action.second);
+}
+
+template<uint32_t ThreadCount>
+bool EngineContext::happens_before(const uint32_t a, const uint32_t b) const
+{
+	const uint32_t thread_count = ThreadCount ? ThreadCount : snps.size();
+	const pair<uint32_t, uint32_t> ta = to_thread_action[a], tb = to_thread_action[b];
+	if (ta.first == tb.first)
+		return ta.second <= tb.second;
+	return last_synaction[b] != -1 && ta.second < clocks[last_synaction[b] * thread_count + ta.first];
+}
+
+/// Computes, for every global action index, whether the action is a read whose value can influence the execution result and stores it in ctx.relevant
+/// (a read is relevant if a print depends on it, if it can see a write which can cause an exception, or if a write depends on it that can be seen by a relevant read);
+/// which write an irrelevant read sees doesn't change the execution result, as long as it doesn't create a dependency cycle
+static void find_relevant_reads(EngineContext& ctx)
+{
+	const vec<Snippet>& snps = ctx.snps;
+
+	// for each variable id, the global indices of all the writes to it
+	vec<vec<uint32_t>> writes_to(ctx.object_count);
+
+	// for each variable id, true iff it has a write which can cause an exception
+	vec<bool> throwing_variable(ctx.object_count, false);
+
+	for (uint32_t i = 0; i < ctx.globc; i++)
+		if (ctx.get_action(i).is_write())
+		{
+			writes_to[ctx.object_id[i]].push_back(i);
+			if (snps[ctx.to_thread_action[i].first].may_write_throw(ctx.to_thread_action[i].second))
+				throwing_variable[ctx.object_id[i]] = true;
+		}
+
+	vec<bool>& relevant = ctx.relevant;
+	relevant.assign(ctx.globc, false);
+
+	// relevant reads whose possibly seen writes haven't been processed yet
+	vec<uint32_t> pending;
+
+	const auto mark = [&](const uint32_t globi)
+	{
+		if (!relevant[globi])
+		{
+			relevant[globi] = true;
+			pending.push_back(globi);
+		}
+	};
+
+	for (uint32_t i = 0; i < snps.size(); i++)
+		for (const uint32_t dep : snps[i].get_output_dependencies())
+			mark(ctx.to_glob_action[i][dep]);
+	for (const uint32_t read : ctx.reads)
+		if (throwing_variable[ctx.object_id[read]])
+			mark(read);
+
+	while (!pending.empty())
+	{
+		const uint32_t cur = pending.back();
+		pending.pop_back();
+		for (const uint32_t write : writes_to[ctx.object_id[cur]])
+		{
+			const pair<uint32_t, uint32_t> wthreada = ctx.to_thread_action[write];
+			for (const uint32_t dep : snps[wthreada.first].get_write_dependencies(wthreada.second))
+				mark(ctx.to_glob_action[wthreada.first][dep]);
+		}
+	}
+}
+
+/// Passes a new execution result to the sink of the analysis and cancels the analysis if the sink asks for it
+static void report_result(EngineContext& ctx, const ExecutionResult& res)
+{
+	if (ctx.sink && !ctx.sink(res))
+		ctx.status = AnalysisStatus::Cancelled;
+}
+
+/// Adds the regular execution result stored in ctx.newout to results and reports it if it is new (it is only copied out of the scratch buffer to be reported)
+static void add_newout(EngineContext& ctx, ResultStore& results)
+{
+	if (results.add_flat(ctx.newout.data()) && ctx.sink)
+		report_result(ctx, { results.unflatten(ctx.newout.data()) });
+}
+
+/// Accounts for the evaluation of one more write-seen candidate; returns false (and ends the analysis) if the candidate budget has run out
+static bool take_candidate(EngineContext& ctx)
+{
+	if (ctx.candidates_left == 0)
+	{
+		ctx.status = AnalysisStatus::BudgetExhausted;
+		return false;
 	}
+	ctx.candidates_left--;
+	return true;
+}
+
+/// Returns the approximate number of bytes of memory used by ctx, its workers and results
+static uint64_t total_memory_use(const EngineContext& ctx, const ResultStore& results);
+
+/// Checks that the memory used by ctx and results is within the memory limit of the analysis; returns false (and ends the analysis) if it isn't
+static bool check_memory_limit(EngineContext& ctx, const ResultStore& results)
+{
+	if (!ctx.memory_limit || total_memory_use(ctx, results) <= ctx.memory_limit)
+		return true;
+	ctx.status = AnalysisStatus::MemoryExhausted;
+	return false;
+}
+
+/// Builds the dependency graph between the reads given by the write-seen function write_seen: fills ctx.used_by, ctx.outstanding and ctx.ready
+/// with the reads that don't depend on any other read
+static void build_read_dependencies(EngineContext& ctx, const vec<int32_t>& write_seen)
+{
+	vec<uint32_t>& outstanding = ctx.outstanding;
+	vec<vec<uint32_t>>& used_by = ctx.used_by;
+
+	for (vec<uint32_t>& dependents : used_by)
+		dependents.clear();
+
+	for (uint32_t nr = 0; nr < ctx.reads.size(); nr++)
+	{
+		if (write_seen[nr] != -1)
+		{
+			const pair<uint32_t, uint32_t> wthreada = ctx.to_thread_action[write_seen[nr]];
+			const ReadSetView deps = ctx.snps[wthreada.first].get_write_dependencies(wthreada.second);
+			outstanding[nr] = deps.size();
+			for (const uint32_t dep : deps)
+				used_by[ctx.gintr_to_rix[ctx.to_glob_action[wthreada.first][dep]]].push_back(nr);
+		}
+		else
+			outstanding[nr] = 0;
+	}
+
+	ctx.ready.clear();
+	for (uint32_t i = 0; i < ctx.reads.size(); i++)
+		if (outstanding[i] == 0)
+			ctx.ready.push_back(i);
+}
+
+/// Returns true iff the write-seen function in ctx.write_seen forms a dependency cycle, for programs with at most Words * 64 reads: the reads whose dependencies
+/// have all been evaluated are marked as evaluated in a fixed-size bit set until no more of them can be (the dependencies of a read are the set of its seen write
+/// in ctx.write_read_deps, so nothing has to be built for the candidate)
+template<uint32_t Words>
+static bool has_small_dependency_cycle(const EngineContext& ctx)
+{
+	const uint32_t read_count = ctx.reads.size();
+	uint64_t done[Words] = {};
+	for (bool progress = true; progress;)
+	{
+		progress = false;
+		for (uint32_t nr = 0; nr < read_count; nr++)
+		{
+			const uint64_t bit = uint64_t(1) << (nr % 64);
+			if (done[nr / 64] & bit)
+				continue;
+			const int32_t write = ctx.write_seen[nr];
+			bool ready = true;
+			if (write != -1)
+			{
+				const uint64_t *const deps = &ctx.write_read_deps[write * Words];
+				for (uint32_t w = 0; w < Words; w++)
+					ready &= (deps[w] & ~done[w]) == 0;
+			}
+			if (ready)
+			{
+				done[nr / 64] |= bit;
+				progress = true;
+			}
+		}
+	}
+	uint32_t done_count = 0;
+	for (uint32_t w = 0; w < Words; w++)
+		done_count += std::bitset<64>(done[w]).count();
+	return done_count != read_count;
+}
+
+/// Returns true iff the write-seen function in ctx.write_seen forms a dependency cycle (for programs with many reads, it uses the same scratch buffers
+/// as analyze_fixed_write_seen)
+static bool has_dependency_cycle(EngineContext& ctx)
+{
+	switch (ctx.read_set_words)
+	{
+		case 1:
+			return has_small_dependency_cycle<1>(ctx);
+		case 2:
+			return has_small_dependency_cycle<2>(ctx);
+		case 4:
+			return has_small_dependency_cycle<4>(ctx);
+	}
+
+	build_read_dependencies(ctx, ctx.write_seen);
+
+	// number of reads removed from the graph; all of them are removed iff there is no cycle
+	uint32_t reads_done = 0;
+	while (!ctx.ready.empty())
+	{
+		const uint32_t cur = ctx.ready.back();
+		ctx.ready.pop_back();
+		reads_done++;
+		for (const uint32_t dependent : ctx.used_by[cur])
+			if (--ctx.outstanding[dependent] == 0)
+				ctx.ready.push_back(dependent);
+	}
+	return reads_done != ctx.reads.size();
+}
+
+/// Simulates the execution of the program given a particular write-seen function (it either produces the corresponding output or,
+/// if the write-seen function forms a dependency cycle, returns without producing any output)
+static void analyze_fixed_write_seen(EngineContext& ctx, const vec<int32_t>& write_seen, ResultStore& results)
+{
+	vec<Snippet>& snps = ctx.snps;
+	vec<uint32_t>& outstanding = ctx.outstanding;
+	vec<vec<uint32_t>>& used_by = ctx.used_by;
+	vec<uint32_t>& ready = ctx.ready;
+
+	for (Snippet& snp : snps)
+		snp.prepare_execution();
+
+	build_read_dependencies(ctx, write_seen);
 
 	// whether a division by zero exception has happened
 	bool excepted = false;
@@ -121,409 +812,1065 @@ static void analyze_fixed_write_seen(vec<Snippet>& snps, const uint32_t globc, c
 	// thread and line number where the zero exception has happened (assuming it has)
 	uint32_t excepted_thread, excepted_line;
 
-	// all reasd that can be evaluated (because all their dependencies have already been evaluated)
-	vec<uint32_t> ready;
+	// number of already evaluated reads
+	uint32_t reads_done = 0;
+
+	// keep evaluating reads as long as there are some that can be evaluated
+	while (!ready.empty())
+	{
+		const uint32_t cur = ready.back();
+		ready.pop_back();
+		reads_done++;
+		const pair<uint32_t, uint32_t> readti = ctx.to_thread_action[ctx.reads[cur]];
+		const int32_t val = write_seen[cur] != -1 ? [&]()
+		{ 
+			const pair<uint32_t, uint32_t> writeti = ctx.to_thread_action[write_seen[cur]];
+			const int32_t value = snps[writeti.first].read_write(writeti.second);
+			if (snps[writeti.first].is_zerodiv_excepted())
+			{
+				excepted = true;
+				excepted_thread = writeti.first;
+				excepted_line = snps[writeti.first].get_excepted_line();
+			}
+			return value;
+		}() : 0;
+		if (excepted)
+			break;
+		snps[readti.first].supply_read_value(readti.second, val);
+		for (const uint32_t dependent : used_by[cur])
+		{
+			outstanding[dependent]--;
+			if (outstanding[dependent] == 0)
+				ready.push_back(dependent);
+
+		}
+	}
+
+	// reads_done == reads.size() means that the program was successfully executed with this write-seen function,
+	// i.e., there were no dependency cycles
+
+	if (!excepted && reads_done == ctx.reads.size())
+	{
+		for (uint32_t i = 0; i < snps.size(); i++)
+		{
+			Snippet& snp = snps[i];
+			snp.get_execution_results(&ctx.newout[ctx.print_offsets[i]]);
+			if (snp.is_zerodiv_excepted())
+			{
+				excepted = true;
+				excepted_thread = i;
+				excepted_line = snp.get_excepted_line();
+				break;
+			}
+		}
+
+		if (!excepted)
+			add_newout(ctx, results);
+	}
+	if (excepted)
+	{
+		const ExecutionResult res{ ExceptedExecutionResult{ excepted_thread, excepted_line } };
+		if (results.add(res))
+			report_result(ctx, res);
+	}
+	ctx.incremental_valid = ctx.incremental && !excepted && reads_done == ctx.reads.size();
+}
+
+/// Evaluates the current write-seen candidate, which differs from the last evaluated one only in the write seen by the read with index rix (which used to be old_write);
+/// re-evaluates only the reads (and the instructions in the snippets) that depend on that read; can only be used if ctx.incremental_valid is true
+static void analyze_changed_read(EngineContext& ctx, const uint32_t rix, const int32_t old_write, ResultStore& results)
+{
+	vec<Snippet>& snps = ctx.snps;
+	const vec<int32_t>& write_seen = ctx.write_seen;
+	vec<vec<uint32_t>>& used_by = ctx.used_by;
+
+	// the reads that the write depends on (none for the initial write)
+	const auto write_deps = [&ctx](const int32_t write)
+	{
+		if (write == -1)
+			return ReadSetView{ nullptr, nullptr };
+		const pair<uint32_t, uint32_t> wthreada = ctx.to_thread_action[write];
+		return ctx.snps[wthreada.first].get_write_dependencies(wthreada.second);
+	};
+	const auto dep_rix = [&ctx](const int32_t write, const uint32_t dep)
+	{
+		return ctx.gintr_to_rix[ctx.to_glob_action[ctx.to_thread_action[write].first][dep]];
+	};
+
+	// replace the edges of the dependency graph coming into the changed read
+	for (const uint32_t dep : write_deps(old_write))
+	{
+		vec<uint32_t>& dependents = used_by[dep_rix(old_write, dep)];
+		*std::find(dependents.begin(), dependents.end(), rix) = dependents.back();
+		dependents.pop_back();
+	}
+	const ReadSetView new_deps = write_deps(write_seen[rix]);
+	for (const uint32_t dep : new_deps)
+		used_by[dep_rix(write_seen[rix], dep)].push_back(rix);
+
+	// find all reads that (transitively) depend on the changed read
+	ctx.visit_number++;
+	ctx.affected.clear();
+	ctx.dfs_stack.clear();
+	ctx.dfs_stack.push_back({ rix, 0 });
+	ctx.visited_in[rix] = ctx.visit_number;
+	while (!ctx.dfs_stack.empty())
+	{
+		auto& cur = ctx.dfs_stack.back();
+		if (cur.second == used_by[cur.first].size())
+		{
+			ctx.affected.push_back(cur.first);
+			ctx.dfs_stack.pop_back();
+		}
+		else
+		{
+			const uint32_t next = used_by[cur.first][cur.second++];
+			if (ctx.visited_in[next] != ctx.visit_number)
+			{
+				ctx.visited_in[next] = ctx.visit_number;
+				ctx.dfs_stack.push_back({ next, 0 });
+			}
+		}
+	}
+
+	// the new candidate has a dependency cycle iff the newly seen write depends on a read that depends on the changed read
+	for (const uint32_t dep : new_deps)
+		if (ctx.visited_in[dep_rix(write_seen[rix], dep)] == ctx.visit_number)
+		{
+			ctx.incremental_valid = false;
+			return;
+		}
+
+	for (const uint32_t read : ctx.affected)
+	{
+		const pair<uint32_t, uint32_t> readti = ctx.to_thread_action[ctx.reads[read]];
+		snps[readti.first].invalidate_read_dependents(readti.second);
+	}
+
+	// re-evaluate the affected reads in a topological order (the reverse of the postorder)
+	for (uint32_t i = ctx.affected.size(); i-- > 0;)
+	{
+		const uint32_t read = ctx.affected[i];
+		const pair<uint32_t, uint32_t> readti = ctx.to_thread_action[ctx.reads[read]];
+		int32_t val = 0;
+		if (write_seen[read] != -1)
+		{
+			const pair<uint32_t, uint32_t> writeti = ctx.to_thread_action[write_seen[read]];
+			val = snps[writeti.first].read_write(writeti.second);
+		}
+		snps[readti.first].supply_read_value(readti.second, val);
+	}
+
+	for (uint32_t i = 0; i < snps.size(); i++)
+		snps[i].get_execution_results(&ctx.newout[ctx.print_offsets[i]]);
+	add_newout(ctx, results);
+}
+
+/// The maximal number of candidates evaluated directly in a row before another batch is tried
+static const uint32_t max_unbatched_run = 1 << 16;
+
+/// Evaluates the candidates waiting in ctx.batch; the candidates in which some instruction divides by zero are evaluated again one by one by analyze_fixed_write_seen,
+/// which finds the exception that is reported
+static void flush_batch(EngineContext& ctx, ResultStore& results)
+{
+	const uint32_t zerodiv = ctx.batch->evaluate(ctx.batch_size);
+	if (std::bitset<32>(zerodiv).count() * 2 > ctx.batch_size)
+	{
+		ctx.unbatched_left = ctx.unbatched_run;
+		ctx.unbatched_run = std::min(ctx.unbatched_run * 2, max_unbatched_run);
+	}
+	else
+		ctx.unbatched_run = BatchEvaluator::lane_count;
+	for (uint32_t lane = 0; lane < ctx.batch_size && ctx.status != AnalysisStatus::Cancelled; lane++)
+	{
+		if (zerodiv & (1u << lane))
+			analyze_fixed_write_seen(ctx, ctx.batch->get_candidate(lane), results);
+		else
+		{
+			ctx.batch->get_execution_results(lane, ctx.newout.data());
+			add_newout(ctx, results);
+		}
+	}
+	ctx.batch_size = 0;
+}
+
+/// Adds the current write-seen candidate in ctx.write_seen to the batch (unless it has a dependency cycle and so produces no output) and evaluates the batch once it is full
+static void batch_write_seen(EngineContext& ctx, ResultStore& results)
+{
+	if (ctx.unbatched_left)
+	{
+		ctx.unbatched_left--;
+		analyze_fixed_write_seen(ctx, ctx.write_seen, results);
+		return;
+	}
+	if (has_dependency_cycle(ctx))
+		return;
+	ctx.batch->set_candidate(ctx.batch_size++, ctx.write_seen);
+	if (ctx.batch_size == BatchEvaluator::lane_count)
+		flush_batch(ctx, results);
+}
+
+/// Returns true iff no monitor is locked in the synchronization order so while another thread holds it
+static bool is_so_well_locked(EngineContext& ctx, const vec<uint32_t>& so)
+{
+	const uint32_t synaction_count = ctx.synaction_count;
+	vec<uint32_t>& holding_thread = ctx.holding_thread;
+	vec<uint32_t>& hold_count = ctx.hold_count;
+	std::fill(hold_count.begin(), hold_count.end(), 0);
+
+	for (uint32_t i = 0; i < synaction_count; i++)
+	{
+		const Instruction& action = ctx.get_action(so[i]);
+		const uint32_t mid = ctx.object_id[so[i]];
+		if (action.is_lock())
+		{
+			const uint32_t this_thread = ctx.to_thread_action[so[i]].first;
+			if (hold_count[mid] && holding_thread[mid] != this_thread)
+				return false;
+			hold_count[mid]++;
+			holding_thread[mid] = this_thread;
+		}
+		else if (action.is_unlock())
+		{
+			assert(hold_count[mid]);
+			assert(holding_thread[mid] == ctx.to_thread_action[so[i]].first);
+			hold_count[mid]--;
+		}
+	}
+	return true;
+}
+
+/// Computes the vector clocks (ctx.clocks) of the synchronization actions in the synchronization order so: every synchronization action starts with the clock
+/// of the previous one in its thread and, if it is a lock or a volatile read, it joins the clocks of all the preceding unlocks or volatile writes
+/// it synchronizes with (program order and synchronizes-with are the only edges of HB, so its transitive closure is covered this way)
+/// ThreadCount is the number of threads if it is known at compile time (so that the loops over the clocks have a fixed length), otherwise 0
+template<uint32_t ThreadCount>
+static void compute_happens_before(EngineContext& ctx, const vec<uint32_t>& so)
+{
+	const uint32_t synaction_count = ctx.synaction_count;
+	const uint32_t thread_count = ThreadCount ? ThreadCount : ctx.snps.size();
+	vec<uint32_t>& clocks = ctx.clocks;
+	vec<uint32_t>& released = ctx.released;
+	std::fill(released.begin(), released.end(), 0);
+	for (uint32_t i = 0; i < synaction_count; i++)
+	{
+		const Instruction& action = ctx.get_action(so[i]);
+		const pair<uint32_t, uint32_t> threada = ctx.to_thread_action[so[i]];
+		const uint32_t k = ctx.last_synaction[so[i]];
+		uint32_t *const clock = &clocks[k * thread_count];
+		if (k > ctx.synaction_base[threada.first])
+			std::copy_n(clock - thread_count, thread_count, clock);
+		else
+			std::fill_n(clock, thread_count, 0);
+		clock[threada.first] = threada.second + 1;
+
+		uint32_t *const object_released = &released[ctx.object_id[so[i]] * thread_count];
+		if (action.is_lock() || action.is_volatile_read())
+			for (uint32_t t = 0; t < thread_count; t++)
+				clock[t] = std::max(clock[t], object_released[t]);
+		else if (action.is_unlock() || action.is_volatile_write())
+			for (uint32_t t = 0; t < thread_count; t++)
+				object_released[t] = std::max(object_released[t], clock[t]);
+	}
+}
+
+/// Computes the writes that every shared read can see (ctx.pss_write_seen) according to the happens-before order computed by compute_happens_before
+/// (ThreadCount like for compute_happens_before)
+template<uint32_t ThreadCount>
+static void compute_seeable_writes(EngineContext& ctx)
+{
+	vec<vec<int32_t>>& pss_write_seen = ctx.pss_write_seen;
+	vec<uint32_t>& preceding_writes = ctx.preceding_writes;
+
+	for (uint32_t nshr = 0; nshr < ctx.shared_reads.size(); nshr++)
+	{
+		const uint32_t i = ctx.shared_reads[nshr];
+		vec<int32_t>& seeable = pss_write_seen[nshr];
+		seeable.clear();
+		preceding_writes.clear();
+
+		// the writes of each thread that happen before the read form a prefix of the thread's writes and the ones that the read happens before form a suffix,
+		// the writes in between are unordered with the read and so seeable (an irrelevant read doesn't need them, it sees only the last seeable write)
+		for (const vec<uint32_t>& writes : ctx.thread_writes[ctx.object_id[i]])
+		{
+			const auto preceding_end = std::partition_point(writes.begin(), writes.end(), [&ctx, i](const uint32_t w){ return ctx.template happens_before<ThreadCount>(w, i); });
+			if (ctx.relevant[i])
+			{
+				const auto following_begin = std::partition_point(preceding_end, writes.end(), [&ctx, i](const uint32_t w){ return !ctx.template happens_before<ThreadCount>(i, w); });
+				seeable.insert(seeable.end(), preceding_end, following_begin);
+			}
+			if (preceding_end != writes.begin())
+				preceding_writes.push_back(*(preceding_end - 1));
+		}
+
+		// only the last preceding write of a thread can be a maximal one (the others happen before it)
+		for (const uint32_t p0 : preceding_writes)
+			if (std::all_of(preceding_writes.begin(), preceding_writes.end(), [&ctx, p0](const uint32_t p1){ return p0 == p1 || !ctx.template happens_before<ThreadCount>(p0, p1); }))
+				seeable.push_back(p0);
+		if (preceding_writes.empty())
+			seeable.push_back(-1);
+
+		// an irrelevant read sees only one write, the last one in seeable is never part of a dependency cycle (it is the initial write or precedes the read in HB)
+		if (!ctx.relevant[i])
+			seeable.erase(seeable.begin(), seeable.end() - 1);
+	}
+}
+
+/// Largest number of threads for which compute_happens_before and compute_seeable_writes are instantiated with a fixed number of threads
+static constexpr uint32_t max_fixed_thread_count = 4;
+
+/// Calls kernel with the number of threads of ctx as a compile-time constant (std::integral_constant) if there is an instantiation for it, otherwise with 0
+template<typename F>
+static void dispatch_thread_count(const EngineContext& ctx, const F& kernel)
+{
+	static_assert(max_fixed_thread_count == 4, "the cases of dispatch_thread_count have to match max_fixed_thread_count");
+	switch (ctx.snps.size())
+	{
+		case 1:
+			return kernel(std::integral_constant<uint32_t, 1>());
+		case 2:
+			return kernel(std::integral_constant<uint32_t, 2>());
+		case 3:
+			return kernel(std::integral_constant<uint32_t, 3>());
+		case 4:
+			return kernel(std::integral_constant<uint32_t, 4>());
+		default:
+			return kernel(std::integral_constant<uint32_t, 0>());
+	}
+}
+
+/// Computes the vector clocks of the synchronization order so and the writes that every shared read can see (see compute_happens_before and compute_seeable_writes)
+static void compute_so_relations(EngineContext& ctx, const vec<uint32_t>& so)
+{
+	dispatch_thread_count(ctx, [&ctx, &so](const auto thread_count)
+	{
+		compute_happens_before<decltype(thread_count)::value>(ctx, so);
+		compute_seeable_writes<decltype(thread_count)::value>(ctx);
+	});
+}
+
+/// Prepares ctx for the evaluation of the write-seen candidates of the synchronization order so: computes the writes that the shared reads can see
+/// and the writes seen by the volatile reads; returns false if so isn't well locked (and so has no candidates)
+static bool prepare_fixed_so(EngineContext& ctx, const vec<uint32_t>& so)
+{
+	const uint32_t synaction_count = ctx.synaction_count;
+	if (!is_so_well_locked(ctx, so))
+		return false;
+	compute_so_relations(ctx, so);
+
+	// the writes seen by the volatile reads depend only on the synchronization order, so they are resolved once in a single sweep over it
+	vec<int32_t>& write_seen = ctx.write_seen;
+	vec<int32_t>& last_writer = ctx.last_writer;
+	std::fill(last_writer.begin(), last_writer.end(), -1);
+	for (uint32_t i = 0; i < synaction_count; i++)
+	{
+		const Instruction& action = ctx.get_action(so[i]);
+		if (action.is_volatile_write())
+			last_writer[ctx.object_id[so[i]]] = so[i];
+		else if (action.is_volatile_read())
+			write_seen[ctx.gintr_to_rix[so[i]]] = last_writer[ctx.object_id[so[i]]];
+	}
+	return true;
+}
+
+/// Number of write-seen candidates of a synchronization order evaluated between two checks of the memory limit
+static constexpr uint64_t memory_check_interval = 1 << 16;
+
+/// Evaluates the write-seen candidates of the synchronization order prepared by prepare_fixed_so in which every shared read with index fixed_from or greater
+/// sees the write given by its index in ctx.write_seen_i (the candidates of the other shared reads are enumerated)
+static void enumerate_write_seen(EngineContext& ctx, const uint32_t fixed_from, ResultStore& results)
+{
+	const vec<vec<int32_t>>& pss_write_seen = ctx.pss_write_seen;
+	vec<int32_t>& write_seen = ctx.write_seen;
+
+	// start with every enumerated shared read seeing the first of its seeable writes
+	vec<uint32_t>& write_seen_i = ctx.write_seen_i;
+	std::fill(write_seen_i.begin(), write_seen_i.begin() + fixed_from, 0);
+	std::fill(ctx.gray_ascending.begin(), ctx.gray_ascending.end(), true);
+	for (uint32_t nshr = 0; nshr < ctx.shared_reads.size(); nshr++)
+		write_seen[ctx.shared_read_rix[nshr]] = pss_write_seen[nshr][write_seen_i[nshr]];
+
+	if (!take_candidate(ctx))
+		return;
+	if (ctx.incremental)
+		analyze_fixed_write_seen(ctx, write_seen, results);
+	else
+		batch_write_seen(ctx, results);
+
+	// go through the remaining candidates in a (mixed-radix reflected) Gray code order, so that every candidate differs from the previous one in exactly one read
+	while (ctx.status == AnalysisStatus::Completed)
+	{
+		uint32_t poi = 0;
+		while (poi < fixed_from)
+		{
+			if (ctx.gray_ascending[poi] ? write_seen_i[poi] + 1 < pss_write_seen[poi].size() : write_seen_i[poi] > 0)
+				break;
+			ctx.gray_ascending[poi] = !ctx.gray_ascending[poi];
+			poi++;
+		}
+		if (poi == fixed_from)
+			break;
+		if (!take_candidate(ctx))
+			return;
+		// the results grow with the candidates, so the memory is checked every now and then
+		if (ctx.candidates_left % memory_check_interval == 0 && !check_memory_limit(ctx, results))
+			return;
+		write_seen_i[poi] += ctx.gray_ascending[poi] ? 1 : -1;
+
+		const uint32_t rix = ctx.shared_read_rix[poi];
+		const int32_t old_write = write_seen[rix];
+		write_seen[rix] = pss_write_seen[poi][write_seen_i[poi]];
+		if (!ctx.incremental)
+			batch_write_seen(ctx, results);
+		else if (ctx.incremental_valid)
+			analyze_changed_read(ctx, rix, old_write, results);
+		else
+			analyze_fixed_write_seen(ctx, write_seen, results);
+	}
+}
+
+/// Returns the number of print statements of every snippet
+static vec<uint32_t> get_print_counts(const vec<Snippet>& snps)
+{
+	vec<uint32_t> print_counts;
+	for (const Snippet& snp : snps)
+		print_counts.push_back(snp.print_count());
+	return print_counts;
+}
+
+EngineWorker::EngineWorker(const vec<Snippet>& snps)
+	: snps(snps), ctx(this->snps, no_sink, candidates_left)
+{
+	find_relevant_reads(ctx);
+}
+
+static uint64_t total_memory_use(const EngineContext& ctx, const ResultStore& results)
+{
+	uint64_t use = ctx.memory_use() + results.memory_use();
+	for (const std::unique_ptr<EngineWorker>& worker : ctx.workers)
+		use += worker->ctx.memory_use() + (worker->results ? worker->results->memory_use() : 0);
+	return use;
+}
+
+/// Returns the number of threads (at most ctx.worker_count) that can evaluate the candidates of a synchronization order within the memory limit
+/// (every thread that doesn't exist yet needs about as much memory as ctx itself)
+static uint32_t affordable_worker_count(const EngineContext& ctx, const ResultStore& results)
+{
+	if (!ctx.memory_limit)
+		return ctx.worker_count;
+	const uint64_t use = total_memory_use(ctx, results);
+	const uint64_t free_memory = use < ctx.memory_limit ? ctx.memory_limit - use : 0;
+	return std::min<uint64_t>(ctx.worker_count, ctx.workers.size() + free_memory / std::max<uint64_t>(ctx.memory_use(), 1));
+}
+
+/// Minimal number of write-seen candidates of a synchronization order for them to be evaluated by several threads
+static constexpr double min_parallel_candidates = 1 << 16;
+
+/// Number of tasks (fixed writes seen by the last shared reads) per thread in enumerate_write_seen_in_parallel, so that the threads get similar amounts of work
+static constexpr uint64_t tasks_per_worker = 8;
+
+/// Multiplies a by b, saturating at the maximal value of uint64_t
+static uint64_t saturating_multiply(const uint64_t a, const uint64_t b)
+{
+	return b && a > std::numeric_limits<uint64_t>::max() / b ? std::numeric_limits<uint64_t>::max() : a * b;
+}
 
-	for (uint32_t i = 0; i < reads.size(); i++)
-		if (outstanding[i] == 0)
-			ready.push_back(i);
+/// Evaluates the write-seen candidates of the synchronization order prepared by prepare_fixed_so with worker_count threads: every task fixes the writes seen
+/// by the last shared reads and the threads take the tasks round-robin, each with its own copies of the snippets and its own results, which are merged
+/// into results (and the new ones reported) once all the threads have finished; the candidate budget is split among the threads in advance
+static void enumerate_write_seen_in_parallel(EngineContext& ctx, const uint32_t worker_count, ResultStore& results)
+{
+	const vec<vec<int32_t>>& pss_write_seen = ctx.pss_write_seen;
+	while (ctx.workers.size() < worker_count)
+		ctx.workers.push_back(std::make_unique<EngineWorker>(ctx.snps));
 
-	// number of already evaluated reads
-	uint32_t reads_done = 0;
+	uint32_t fixed_from = ctx.shared_reads.size();
+	uint64_t task_count = 1;
+	while (fixed_from > 0 && task_count < tasks_per_worker * worker_count)
+		task_count *= pss_write_seen[--fixed_from].size();
+	uint64_t task_candidates = 1;
+	for (uint32_t nshr = 0; nshr < fixed_from; nshr++)
+		task_candidates = saturating_multiply(task_candidates, pss_write_seen[nshr].size());
 
-	// keep evaluating reads as long as there are some that can be evaluated
-	while (!ready.empty())
+	// every thread gets its part of the memory for the results (0 stays unlimited)
+	const vec<uint32_t> print_counts = get_print_counts(ctx.snps);
+	const uint64_t memory_limit = results.get_memory_limit() ? std::max<uint64_t>(results.get_memory_limit() / worker_count, 1) : 0;
+	for (uint32_t w = 0; w < worker_count; w++)
 	{
-		const uint32_t cur = ready.back();
-		ready.pop_back();
-		reads_done++;
-		const pair<uint32_t, uint32_t> readti = to_thread_action[reads[cur]];
-		const int32_t val = write_seen[cur] != -1 ? [&]()
-		{ 
-			const pair<uint32_t, uint32_t> writeti = to_thread_action[write_seen[cur]];
-			const int32_t value = snps[writeti.first].read_write(writeti.second);
-			if (snps[writeti.first].is_zerodiv_excepted())
-			{
-				excepted = true;
-				excepted_thread = writeti.first;
-				excepted_line = snps[writeti.first].get_excepted_line();
-			}
-			return value;
-		}() : 0;
-		if (excepted)
-			break;
-		snps[readti.first].supply_read_value(readti.second, val);
-		for (const uint32_t dependent : used_by[cur])
-		{
-			outstanding[dependent]--;
-			if (outstanding[dependent] == 0)
-				ready.push_back(dependent);
-
-		}
+		EngineWorker& worker = *ctx.workers[w];
+		const uint64_t worker_candidates = saturating_multiply((task_count + worker_count - 1 - w) / worker_count, task_candidates);
+		worker.candidates_left = std::min(ctx.candidates_left, worker_candidates);
+		ctx.candidates_left -= worker.candidates_left;
+		worker.results.emplace(print_counts, memory_limit);
 	}
 
-	// reads_done == reads.size() means that the program was successfully executed with this write-seen function,
-	// i.e., there were no dependency cycles
-
-	if (!excepted && reads_done == reads.size())
+	parallel_for(worker_count, [&ctx, fixed_from, task_count, worker_count](const uint32_t w)
 	{
-		vec<vec<int32_t>> newout;
-		for (uint32_t i = 0; i < snps.size(); i++)
+		EngineWorker& worker = *ctx.workers[w];
+		EngineContext& wctx = worker.ctx;
+		wctx.pss_write_seen = ctx.pss_write_seen;
+		wctx.write_seen = ctx.write_seen;
+		wctx.status = AnalysisStatus::Completed;
+		for (uint64_t task = w; task < task_count && wctx.status == AnalysisStatus::Completed; task += worker_count)
 		{
-			Snippet& snp = snps[i];
-			newout.push_back(snp.get_execution_results());
-			if (snp.is_zerodiv_excepted())
+			// the task number in the mixed radix of the numbers of the seeable writes of the fixed reads
+			uint64_t rest = task;
+			for (uint32_t nshr = fixed_from; nshr < wctx.shared_reads.size(); nshr++)
 			{
-				excepted = true;
-				excepted_thread = i;
-				excepted_line = snp.get_excepted_line();
-				break;
+				wctx.write_seen_i[nshr] = rest % wctx.pss_write_seen[nshr].size();
+				rest /= wctx.pss_write_seen[nshr].size();
 			}
+			enumerate_write_seen(wctx, fixed_from, *worker.results);
 		}
-		if (!excepted)
-		{
-			const ExecutionResult res{ newout };
-			if (std::all_of(results.begin(), results.end(), [&res](const ExecutionResult& thisout){ return thisout != res; }))
-				results.push_back(res);
-		}
-	}
-	if (excepted)
+		if (wctx.batch_size)
+			flush_batch(wctx, *worker.results);
+	});
+
+	bool budget_exhausted = false;
+	for (uint32_t w = 0; w < worker_count; w++)
 	{
-		const ExecutionResult res{ ExceptedExecutionResult{ excepted_thread, excepted_line } };
-		if (std::all_of(results.begin(), results.end(), [&res](const ExecutionResult& thisout){ return thisout != res; }))
-			results.push_back(res);
+		EngineWorker& worker = *ctx.workers[w];
+		ctx.candidates_left += worker.candidates_left;
+		budget_exhausted |= worker.ctx.status == AnalysisStatus::BudgetExhausted;
+		if (ctx.status != AnalysisStatus::Cancelled)
+			worker.results->for_each([&ctx, &results](const ExecutionResult& res)
+			{
+				if (results.add(res))
+					report_result(ctx, res);
+				return ctx.status != AnalysisStatus::Cancelled;
+			});
+		worker.results.reset();
 	}
+	if (budget_exhausted && ctx.status == AnalysisStatus::Completed)
+		ctx.status = AnalysisStatus::BudgetExhausted;
 }
 
 /// Iterates through and tries possible executions given a particular synchronization order
-static void analyze_fixed_so(vec<Snippet>& snps, const uint32_t globc, const vec<vec<uint32_t>>& to_glob_action, const vec<std::pair<uint32_t, uint32_t>>& to_thread_action, const vec<uint32_t>& so, const uint32_t synaction_count, vec<ExecutionResult>& results)
+static void analyze_fixed_so(EngineContext& ctx, const vec<uint32_t>& so, ResultStore& results)
 {
-	// check that monitors are paired correctly
-	std::unordered_map<Ident, uint32_t> holding_thread;
-	std::unordered_map<Ident, uint32_t> hold_count;
-
-	const auto get_action = [&](const uint32_t globi) -> const Instruction&
-	{
-		const pair<uint32_t, uint32_t> thread_action = to_thread_action[globi];
-		return snps[thread_action.first].get_action(thread_action.second);
-	};
-
-	for (uint32_t i = 0; i < synaction_count; i++)
+	if (!prepare_fixed_so(ctx, so) || !check_memory_limit(ctx, results))
+		return;
+	if (ctx.worker_count > 1)
 	{
-		const Instruction& action = get_action(so[i]);
-		if (action.is_lock())
-		{
-			const str& mname = action.get_monitor_name();
-			const uint32_t this_thread = to_thread_action[so[i]].first;
-			if (hold_count[mname] && holding_thread[mname] != this_thread)
-				return;
-			hold_count[mname]++;
-			holding_thread[mname] = this_thread;
-		}
-		else if (action.is_unlock())
+		double candidate_count = 1;
+		for (const vec<int32_t>& seeable : ctx.pss_write_seen)
+			candidate_count *= seeable.size();
+		// without enough memory for the threads, fewer of them (or just this one) evaluate the candidates
+		const uint32_t worker_count = candidate_count >= min_parallel_candidates ? affordable_worker_count(ctx, results) : 1;
+		if (worker_count > 1)
 		{
-			const str& mname = action.get_monitor_name();
-			const uint32_t this_thread = to_thread_action[so[i]].first;
-			assert(hold_count[mname]);
-			assert(holding_thread[mname] == this_thread);
-			hold_count[mname]--;
+			enumerate_write_seen_in_parallel(ctx, worker_count, results);
+			return;
 		}
 	}
+	enumerate_write_seen(ctx, ctx.shared_reads.size(), results);
+}
 
-	vec<vec<bool>> hb(globc, vec<bool>(globc, false));
-
-	// add reflexivity to HB
-	for (uint32_t i = 0; i < globc; i++)
-		hb[i][i] = true;
+/// Advances so_thread_alloc (for every place in the synchronization order, the thread whose unit of synchronization actions is there) to the next allocation
+/// in the order in which all of them are generated (units[i] has an element for every unit of thread i); returns false if so_thread_alloc was already the last one
+static bool next_so_thread_alloc(vec<uint32_t>& so_thread_alloc, const vec<vec<uint32_t>>& units)
+{
+	const uint32_t slot_count = so_thread_alloc.size();
 
-	// add (a transitive skeleton) of all the program orders to HB
-	for (uint32_t i = 0; i < snps.size(); i++)
-		for (uint32_t j = 0; j + 1 < snps[i].action_count(); j++)
-			hb[to_glob_action[i][j]][to_glob_action[i][j + 1]] = true;
+	// temporary placeholder value for a free spot in the algorithm that generates all possible synchronization orders
+	const uint32_t free_slot = std::numeric_limits<uint32_t>::max();
 
-	// add the synchronizes-with edges to HB
-	for (uint32_t i = 0; i < synaction_count; i++)
+	for (int32_t i = units.size() - 2; i >= 0; i--)
 	{
-		const Instruction& action = get_action(so[i]);
-		if (action.is_unlock())
-			for (uint32_t j = i + 1; j < synaction_count; j++)
-			{
-				const Instruction& a2 = get_action(so[j]);
-				if (a2.is_lock() && a2.get_monitor_name() == action.get_monitor_name())
-					hb[so[i]][so[j]] = true;
-			}
-		else if (action.is_volatile_write())
-			for (uint32_t j = i + 1; j < synaction_count; j++)
-			{
-				const Instruction& a2 = get_action(so[j]);
-				if (a2.is_volatile_read() && a2.get_volatile_name() == action.get_volatile_name())
-					hb[so[i]][so[j]] = true;
-			}
-	}
-
-	// completes HB by calculating the transitive closure
-	for (uint32_t i = 0; i < globc; i++)
-		for (uint32_t j = 0; j < globc; j++)
-			for (uint32_t k = 0; k < globc; k++)
-				if (hb[j][i] && hb[i][k])
-					hb[j][k] = true;
+		// in each iteration, try to advance the places allocated for thread i forward by one (in a particular order of subsets of a given size)
+		// without moving any allocations for threads with lower indices
+		
+		// lowest visited index that is occupied by a thread with an index greater than i
+		int32_t next_free = -1; 
 
-	// assert that HB is a partial order
-	for (uint32_t i = 0; i < globc; i++)
-		for (uint32_t j = 0; j < globc; j++)
-			assert(i == j || !hb[i][j] || !hb[j][i]);
+		// number of visited indices occupied by thread i
+		uint32_t self_seen = 0;
 
-	// indices of all shared reads
-	vec<uint32_t> shared_reads;
+		bool updated = false;
 
-	// for each shared read, the set of all writes that can be seen by it if compliant with HB
-	vec<vec<int32_t>> pss_write_seen;
+		// iterate through the indices of the synchronization order back to front
+		for (int32_t j = slot_count - 1; j >= 0; j--)
+		{
+			if (so_thread_alloc[j] > static_cast<uint32_t>(i))
+				next_free = j;
+			else if (so_thread_alloc[j] == static_cast<uint32_t>(i))
+			{
+				if (next_free != -1)
+				{
+					so_thread_alloc[j] = free_slot;
+					so_thread_alloc[next_free] = i;
+					for (uint32_t k = next_free + 1; self_seen; k++)
+					{
+						if (so_thread_alloc[k] > static_cast<uint32_t>(i))
+						{
+							so_thread_alloc[k] = i;
+							self_seen--;
+						}
+					}
+					updated = true;
+					break;
+				}
+				else
+				{
+					so_thread_alloc[j] = free_slot;
+					self_seen++;
+				}
+			}
+		}
 
-	for (uint32_t i = 0; i < globc; i++)
-	{
-		const Instruction& action = get_action(i);
-		if (action.is_shared_read())
+		// after updating the subset of slots allocated for thread i, change the configuration of the threads with indices > i to the minimum
+		
+		if (updated)
 		{
-			shared_reads.push_back(i);
-			vec<int32_t> seeable;
-			vec<uint32_t> preceding_writes;
-			for (uint32_t j = 0; j < globc; j++)
+			uint32_t nxt = 0;
+			for (uint32_t j = i + 1; j < units.size(); j++)
 			{
-				const Instruction& a2 = get_action(j);
-				if (a2.is_shared_write() && action.get_shared_name() == a2.get_shared_name())
+				uint32_t left = units[j].size();
+				while (left)
 				{
-					if (hb[j][i])
-						preceding_writes.push_back(j);
-					else if (!hb[i][j])
-						seeable.push_back(j);
+					if (so_thread_alloc[nxt] > static_cast<uint32_t>(i))
+					{
+						so_thread_alloc[nxt] = j;
+						left--;
+					}
+					nxt++;
 				}
 			}
-			for (const uint32_t p0 : preceding_writes)
-				if (std::all_of(preceding_writes.begin(), preceding_writes.end(), [&hb, p0](const uint32_t p1){ return p0 == p1 || !hb[p0][p1]; }))
-					seeable.push_back(p0);
-			if (preceding_writes.empty())
-				seeable.push_back(-1);
-			pss_write_seen.push_back(seeable);
+			return true;
 		}
 	}
+	return false;
+}
 
-	// map: global action index of a read action -> index of the read
-	std::unordered_map<uint32_t, uint32_t> gintr_to_rix;
+/// Stores the first allocation of the synchronization order (all the units of synchronization actions of thread 0, then of thread 1 etc.) into so_thread_alloc
+static void first_so_thread_alloc(const EngineContext& ctx, vec<uint32_t>& so_thread_alloc)
+{
+	so_thread_alloc.resize(ctx.so_unit_count);
+	uint32_t nxt = 0;
+	for (uint32_t i = 0; i < ctx.snps.size(); i++)
+		for (uint32_t j = 0; j < ctx.so_units[i].size(); j++)
+			so_thread_alloc[nxt++] = i;
+}
 
-	// global action indices of all read actions
-	vec<uint32_t> reads;
+/// Stores into so the global indices of the synchronization actions in the order given by so_thread_alloc (nxts is a scratch buffer)
+static void build_so(const EngineContext& ctx, const vec<uint32_t>& so_thread_alloc, vec<uint32_t>& nxts, vec<uint32_t>& so)
+{
+	nxts.assign(ctx.snps.size(), 0);
+	so.clear();
+	for (uint32_t threadi = 0; threadi < ctx.snps.size(); threadi++)
+		for (uint32_t k = 0; k < ctx.so_prefix[threadi]; k++)
+			so.push_back(ctx.to_glob_action[threadi][ctx.synactions[threadi][k]]);
+	for (const uint32_t threadi : so_thread_alloc)
+	{
+		const vec<uint32_t>& unit_ends = ctx.so_units[threadi];
+		const uint32_t unit = nxts[threadi]++;
+		for (uint32_t k = unit ? unit_ends[unit - 1] : ctx.so_prefix[threadi]; k < unit_ends[unit]; k++)
+			so.push_back(ctx.to_glob_action[threadi][ctx.synactions[threadi][k]]);
+	}
+}
 
-	for (uint32_t i = 0; i < globc; i++)
-		if (get_action(i).is_read())
+/// Generates all possible execution results of a program whose snippets have already been checked and have had their preexecution analysis run;
+/// every new result is also passed to sink (if it isn't empty) and at most candidates_left write-seen candidates are evaluated (it is decreased accordingly);
+/// the candidates of a synchronization order with many of them are evaluated by worker_count threads (0 means as many as the hardware runs at once)
+/// and the analysis stops once its structures and the results use more than about memory_limit bytes (0 means no limit)
+static AnalysisStatus analyze_snippets(vec<Snippet>& snps, ResultStore& results, const ResultSink& sink, uint64_t& candidates_left, const uint32_t worker_count,
+	const uint64_t memory_limit)
+{
+	EngineContext ctx(snps, sink, candidates_left);
+	find_relevant_reads(ctx);
+	ctx.worker_count = worker_count ? worker_count : std::max(1u, std::thread::hardware_concurrency());
+	ctx.memory_limit = memory_limit;
+
+	// the current synchronization order allocation -- for every place, indicates an syn. action from which thread should be there
+	vec<uint32_t> so_thread_alloc;
+	first_so_thread_alloc(ctx, so_thread_alloc);
+
+	// index i holds the global index of the syn. action that comes i-th in the syn. order
+	vec<uint32_t> so;
+
+	// for each thread, the number of its syn. actions already placed in so
+	vec<uint32_t> nxts;
+
+	do
+	{
+		build_so(ctx, so_thread_alloc, nxts, so);
+		analyze_fixed_so(ctx, so, results);
+	} while (ctx.status == AnalysisStatus::Completed && next_so_thread_alloc(so_thread_alloc, ctx.so_units));
+
+	// the candidates are independent of the synchronization order they come from, so a batch is only evaluated when it is full or at the very end
+	if (ctx.batch_size && ctx.status != AnalysisStatus::Cancelled)
+		flush_batch(ctx, results);
+	return ctx.status;
+}
+
+/// Splits the threads into groups such that no two threads in different groups use the same shared variable, volatile variable or monitor
+/// (the threads in each group are sorted by their index and the groups are sorted by their first thread)
+static vec<vec<uint32_t>> find_independent_components(const vec<Snippet>& snps)
+{
+	// union-find over the threads: index i holds a thread in the same component (the thread itself if it is the representative)
+	vec<uint32_t> parent(snps.size());
+	for (uint32_t i = 0; i < snps.size(); i++)
+		parent[i] = i;
+	const auto find = [&parent](uint32_t threadi)
+	{
+		while (parent[threadi] != threadi)
+			threadi = parent[threadi] = parent[parent[threadi]];
+		return threadi;
+	};
+
+	// maps the name of a global object to the first thread that uses it
+	std::unordered_map<Ident, uint32_t> first_user;
+	for (uint32_t i = 0; i < snps.size(); i++)
+		for (const Ident& name : snps[i].get_global_names())
 		{
-			gintr_to_rix[i] = reads.size();
-			reads.push_back(i);
+			const auto it = first_user.find(name);
+			if (it == first_user.end())
+				first_user[name] = i;
+			else
+				parent[find(i)] = find(it->second);
 		}
 
-	vec<uint32_t> write_seen_i(shared_reads.size(), 0);
-	while (true)
+	vec<vec<uint32_t>> components;
+	std::unordered_map<uint32_t, uint32_t> component_of_root;
+	for (uint32_t i = 0; i < snps.size(); i++)
 	{
-		// construct write seen from index array
+		const uint32_t root = find(i);
+		if (component_of_root.find(root) == component_of_root.end())
+		{
+			component_of_root[root] = components.size();
+			components.emplace_back();
+		}
+		components[component_of_root[root]].push_back(i);
+	}
+	return components;
+}
+
+/// Combines the execution results of independent components into the execution results of the whole program (every combination of one result per component is possible)
+/// If several components end with an exception in the same combination, the exception in the thread with the lowest index is reported, like when all snippets are analyzed together
+/// Every distinct result is passed to sink; returns false iff the sink has cancelled the analysis
+static bool combine_component_results(const vec<vec<uint32_t>>& components, const vec<vec<ExecutionResult>>& component_results, const uint32_t thread_count, const ResultSink& sink)
+{
+	if (std::any_of(component_results.begin(), component_results.end(), [](const vec<ExecutionResult>& ress){ return ress.empty(); }))
+		return true;
 
-		vec<int32_t> write_seen(reads.size());
-		uint32_t nr = 0, nshr = 0;
-		for (uint32_t i = 0; i < globc; i++)
+	// the exceptions reported so far (different combinations can end with the same exception)
+	vec<ExecutionResult> exceptions;
+
+	// index i holds the index of the result of component i in the current combination
+	vec<uint32_t> choice(components.size(), 0);
+	while (true)
+	{
+		// whether some of the chosen results is an exception and the one in the thread with the lowest index
+		bool excepted = false;
+		ExceptedExecutionResult first_exception{};
+		for (uint32_t i = 0; i < components.size(); i++)
 		{
-			const Instruction& action = get_action(i);
-			if (action.is_volatile_read())
+			const ExecutionResult& res = component_results[i][choice[i]];
+			if (std::holds_alternative<ExceptedExecutionResult>(res.result))
 			{
-				// go up the synchronization order to find the matching write
-				int32_t latest_write = -1;
-				for (uint32_t j = 0; j < synaction_count; j++)
+				const ExceptedExecutionResult& eres = std::get<ExceptedExecutionResult>(res.result);
+				const uint32_t thread = components[i][eres.ex_thread];
+				if (!excepted || thread < first_exception.ex_thread)
 				{
-					const Instruction& waction = get_action(so[j]);
-					if (waction.is_volatile_write() && waction.get_volatile_name() == action.get_volatile_name())
-						latest_write = so[j];
-					else if (so[j] == i)
-						break;
+					first_exception = ExceptedExecutionResult{ thread, eres.ex_line };
+					excepted = true;
 				}
-				write_seen[nr] = latest_write;
-				nr++;
 			}
-			else if (action.is_shared_read())
+		}
+		if (excepted)
+		{
+			const ExecutionResult res{ first_exception };
+			if (std::find(exceptions.begin(), exceptions.end(), res) == exceptions.end())
 			{
-				write_seen[nr] = pss_write_seen[nshr][write_seen_i[nshr]];
-				nshr++;
-				nr++;
+				exceptions.push_back(res);
+				if (!sink(res))
+					return false;
 			}
 		}
-
-		// use write seen
-		analyze_fixed_write_seen(snps, globc, to_glob_action, to_thread_action, get_action, gintr_to_rix, write_seen, reads, results);
-
-		// update write seen index array
-		if (write_seen_i.empty())
-			break;
-		write_seen_i[0]++;
-		uint32_t poi = 0;
-		while (poi < shared_reads.size() && write_seen_i[poi] == pss_write_seen[poi].size())
+		else
 		{
-			write_seen_i[poi] = 0;
-			poi++;
-			if (poi < shared_reads.size())
-				write_seen_i[poi]++;
+			// distinct combinations of regular results are always distinct results of the whole program
+			RegularExecutionResult combined(thread_count);
+			for (uint32_t i = 0; i < components.size(); i++)
+			{
+				const RegularExecutionResult& rres = std::get<RegularExecutionResult>(component_results[i][choice[i]].result);
+				for (uint32_t j = 0; j < components[i].size(); j++)
+					combined[components[i][j]] = rres[j];
+			}
+			if (!sink({ combined }))
+				return false;
 		}
-		if (poi == shared_reads.size())
-			break;
+
+		// move to the next combination
+		uint32_t poi = 0;
+		while (poi < components.size() && ++choice[poi] == component_results[poi].size())
+			choice[poi++] = 0;
+		if (poi == components.size())
+			return true;
 	}
 }
 
-bool analyze(const vec<std::string>& filenames, const vec<std::istream*>& inputs, vec<ExecutionResult>& results, std::ostream& err_out)
+Program::Program() = default;
+
+Program::~Program() = default;
+
+bool Program::parse(const vec<std::string>& filenames, const vec<std::string_view>& sources, std::ostream& err_out)
 {
-	// parse the source code
-	vec<Snippet> snps;
-	snps.reserve(inputs.size());
-	for (uint32_t i = 0; i < inputs.size(); i++)
-	{
+	snps.clear();
+	for (uint32_t i = 0; i < sources.size(); i++)
 		snps.push_back(Snippet(filenames[i]));
-		JMMEScanner scn(inputs[i]);
-		JMMEParser prs(scn, snps.back());
-		prs();
-	}
-	
-	// check that the monitors are used correctly in each file
-	if (check_monitor_use(snps, err_out))
+
+	// the snippets are independent of each other until their threads are analyzed together, so each of them is parsed, checked for the correct use
+	// of the monitors and prepared for the analysis by one task; the error messages of each task are kept apart and printed in the order of the files
+	vec<std::ostringstream> parse_diagnostics(sources.size()), monitor_diagnostics(sources.size());
+	vec<uint8_t> invalid_monitor_use(sources.size());
+	parallel_for(sources.size(), [&](const uint32_t i)
+	{
+		parse_snippet(sources[i], snps[i], parse_diagnostics[i]);
+		invalid_monitor_use[i] = check_monitor_use(snps[i], monitor_diagnostics[i]);
+		if (!invalid_monitor_use[i])
+		{
+			snps[i].optimize();
+			snps[i].run_preexecution_analysis();
+		}
+	});
+	for (const std::ostringstream& diag : parse_diagnostics)
+		std::cerr << diag.str();
+	for (const std::ostringstream& diag : monitor_diagnostics)
+		err_out << diag.str();
+
+	if (std::find(invalid_monitor_use.begin(), invalid_monitor_use.end(), true) != invalid_monitor_use.end())
 	{
 		err_out << "Terminating due to invalid monitor use." << std::endl;
 		return true;
 	}
 
-	// converts from the global indexing of actions to the per-thread indexing
-	vec<pair<uint32_t, uint32_t>> to_thread_action;
+	// threads that don't share any variables or monitors with each other are analyzed separately
+	components = find_independent_components(snps);
+	component_snps.clear();
+	if (components.size() > 1)
+	{
+		for (const vec<uint32_t>& component : components)
+		{
+			component_snps.emplace_back();
+			for (const uint32_t threadi : component)
+				component_snps.back().push_back(snps[threadi]);
+		}
+	}
+	return false;
+}
 
-	// converts from the per-thread indexing of actions to the global indexing
-	vec<vec<uint32_t>> to_glob_action(snps.size());
+uint32_t Program::get_thread_count() const
+{
+	return snps.size();
+}
 
-	// total number of actions
-	uint32_t globc = 0;
+const std::string& Program::get_thread_name(const uint32_t threadi) const
+{
+	return snps[threadi].get_name();
+}
 
-	// populate to_thread_action and to_glob_action
-	for (uint32_t i = 0; i < snps.size(); i++)
+/// Generates the sequentially consistent execution results of a program whose snippets have already been checked and have had their preexecution analysis run
+/// (with the same reporting, budget and memory limit as analyze_snippets, but the budget counts the steps of the interleavings and there is a single thread)
+static AnalysisStatus analyze_snippets_sc(vec<Snippet>& snps, ResultStore& results, const ResultSink& sink, uint64_t& steps_left, uint32_t, const uint64_t memory_limit)
+{
+	InterleavingExplorer explorer(snps);
+	return explorer.explore(results, sink, steps_left, memory_limit);
+}
+
+/// Returns the approximate number of bytes of memory used by res
+static uint64_t result_memory_use(const ExecutionResult& res)
+{
+	uint64_t use = sizeof(ExecutionResult);
+	if (std::holds_alternative<RegularExecutionResult>(res.result))
+		use += vec_memory_use(std::get<RegularExecutionResult>(res.result));
+	return use;
+}
+
+/// Number of write-seen candidates evaluated by estimate_snippets (split evenly among the sampled synchronization orders) to measure the cost of a candidate
+static constexpr uint64_t estimate_probe_candidates = 20000;
+
+/// Adds the predicted size of the analysis of a program whose snippets have already been checked and have had their preexecution analysis run to estimate:
+/// the number of synchronization orders is computed exactly, the mean number of write-seen candidates per order is taken from sample_count uniformly random orders,
+/// the time per order is measured on the samples and the time per candidate by evaluating some of the candidates of every sampled order
+static void estimate_snippets(vec<Snippet>& snps, const uint32_t sample_count, AnalysisEstimate& estimate)
+{
+	using clock = std::chrono::steady_clock;
+	const ResultSink no_sink;
+	uint64_t candidates_left = 0;
+	EngineContext ctx(snps, no_sink, candidates_left);
+	find_relevant_reads(ctx);
+	ResultStore results(get_print_counts(snps), 0);
+
+	// the allocations of the units to the threads are the permutations of a multiset (the multinomial coefficient), every one of them equally likely when shuffled
+	double so_count = 1;
+	uint32_t placed = 0;
+	for (const vec<uint32_t>& units : ctx.so_units)
+		for (uint32_t j = 1; j <= units.size(); j++)
+			so_count = so_count * ++placed / j;
+
+	vec<uint32_t> so_thread_alloc, nxts, so;
+	first_so_thread_alloc(ctx, so_thread_alloc);
+	std::mt19937_64 rng;
+	double candidate_sum = 0;
+	clock::duration sample_time(0), probe_time(0);
+	uint64_t probe_candidate_count = 0;
+	const uint64_t probe_share = std::max<uint64_t>(estimate_probe_candidates / std::max(sample_count, 1u), 1);
+	for (uint32_t i = 0; i < sample_count; i++)
 	{
-		const uint32_t action_count = snps[i].action_count();
-		for (uint32_t j = 0; j < action_count; j++)
+		const clock::time_point start = clock::now();
+		std::shuffle(so_thread_alloc.begin(), so_thread_alloc.end(), rng);
+		build_so(ctx, so_thread_alloc, nxts, so);
+		const bool well_locked = is_so_well_locked(ctx, so);
+		if (well_locked)
 		{
-			to_thread_action.push_back({ i, j });
-			to_glob_action[i].push_back(globc++);
+			estimate.well_locked_so_count++;
+			compute_so_relations(ctx, so);
+			double candidates = 1;
+			for (const vec<int32_t>& seeable : ctx.pss_write_seen)
+				candidates *= seeable.size();
+			candidate_sum += candidates;
 		}
-	}
+		const clock::time_point sampled = clock::now();
+		sample_time += sampled - start;
+		if (!well_locked)
+			continue;
 
-	// for each thread, holds the indices of all synchronziation actions
-	vec<vec<uint32_t>> synactions(snps.size());
+		candidates_left = probe_share;
+		ctx.status = AnalysisStatus::Completed;
+		analyze_fixed_so(ctx, so, results);
+		probe_candidate_count += probe_share - candidates_left;
+		probe_time += clock::now() - sampled;
+	}
+	const clock::time_point flush_start = clock::now();
+	if (ctx.batch_size)
+		flush_batch(ctx, results);
+	probe_time += clock::now() - flush_start;
 
-	// total number of synchronization actions
-	uint32_t synaction_count = 0;
+	const double candidate_count = sample_count ? so_count * candidate_sum / sample_count : 0;
+	const double probe_seconds = std::chrono::duration<double>(probe_time).count();
+	estimate.so_count += so_count;
+	estimate.sampled_so_count += sample_count;
+	estimate.candidate_count += candidate_count;
+	estimate.probe_candidate_count += probe_candidate_count;
+	estimate.probe_seconds += probe_seconds;
+	if (sample_count)
+		estimate.seconds += so_count * std::chrono::duration<double>(sample_time).count() / sample_count;
+	if (probe_candidate_count)
+		estimate.seconds += candidate_count * probe_seconds / probe_candidate_count;
+}
 
-	for (uint32_t i = 0; i < snps.size(); i++)
+AnalysisStatus Program::analyze(const ResultSink& sink, const AnalysisOptions& options)
+{
+	const auto analyze_component = options.sequential_consistency ? analyze_snippets_sc : analyze_snippets;
+	const uint64_t budget = options.candidate_budget ? options.candidate_budget : std::numeric_limits<uint64_t>::max();
+	uint64_t candidates_left = budget;
+	// under a memory limit, the results start being spilled to files once they take half of it
+	const uint64_t result_memory_limit = !options.memory_limit ? options.result_memory_limit
+		: std::min(options.result_memory_limit ? options.result_memory_limit : std::numeric_limits<uint64_t>::max(), std::max<uint64_t>(options.memory_limit / 2, 1));
+	if (component_snps.empty())
 	{
-		synactions[i] = snps[i].get_synchronization_actions();
-		synaction_count += synactions[i].size();
+		// the results that the store couldn't recognize as new right away (after it has started spilling them to files) are reported at the end
+		ResultStore results(get_print_counts(snps), result_memory_limit);
+		AnalysisStatus status = analyze_component(snps, results, sink, candidates_left, options.worker_count, options.memory_limit);
+		candidate_count = budget - candidates_left;
+		if (status != AnalysisStatus::Cancelled && !results.flush(sink))
+			status = AnalysisStatus::Cancelled;
+		return status;
 	}
 
-	// the current synchronization order allocation -- for every place, indicates an syn. action from which thread should be there
-	vec<uint32_t> so_thread_alloc(synaction_count);
+	// the results of a component can only be combined with the others once all of them are known, so only the combined results are streamed
+	// (they are all kept in memory, so they count towards the memory limit as well)
+	AnalysisStatus status = AnalysisStatus::Completed;
+	vec<vec<ExecutionResult>> component_results(components.size());
+	uint64_t component_memory_use = 0;
+	for (uint32_t i = 0; i < components.size() && status == AnalysisStatus::Completed; i++)
 	{
-		uint32_t nxt = 0;
-		for (uint32_t i = 0; i < snps.size(); i++)
-			for (uint32_t j = 0; j < synactions[i].size(); j++)
-				so_thread_alloc[nxt++] = i;
+		ResultStore results(get_print_counts(component_snps[i]), result_memory_limit);
+		status = analyze_component(component_snps[i], results, ResultSink(), candidates_left, options.worker_count,
+			options.memory_limit ? std::max<uint64_t>(options.memory_limit - component_memory_use, 1) : 0);
+		results.for_each([&](const ExecutionResult& res)
+		{
+			component_results[i].push_back(res);
+			component_memory_use += result_memory_use(res);
+			if (!options.memory_limit || component_memory_use <= options.memory_limit)
+				return true;
+			status = AnalysisStatus::MemoryExhausted;
+			return false;
+		});
 	}
+	candidate_count = budget - candidates_left;
+	if (!combine_component_results(components, component_results, snps.size(), sink))
+		return AnalysisStatus::Cancelled;
+	return status;
+}
 
-	for (Snippet& snp : snps)
-		snp.run_preexecution_analysis();
+AnalysisEstimate Program::estimate(const uint32_t sample_count)
+{
+	AnalysisEstimate estimate;
+	if (component_snps.empty())
+		estimate_snippets(snps, sample_count, estimate);
+	for (vec<Snippet>& component : component_snps)
+		estimate_snippets(component, sample_count, estimate);
+	return estimate;
+}
 
-	while (true)
-	{
-		// index i holds the global index of the syn. action that comes i-th in the syn. order
-		vec<uint32_t> so(synaction_count);
-		{
-			vec<uint32_t> nxts(snps.size(), 0);
-			for (uint32_t i = 0; i < synaction_count; i++)
-			{
-				const uint32_t threadi = so_thread_alloc[i];
-				so[i] = to_glob_action[threadi][synactions[threadi][nxts[threadi]++]];
-			}
-		}
+uint64_t Program::get_candidate_count() const
+{
+	return candidate_count;
+}
 
-		analyze_fixed_so(snps, globc, to_glob_action, to_thread_action, so, synaction_count, results);
-		
-		// update so_thread_alloc
+bool analyze(const vec<std::string>& filenames, const vec<std::string_view>& sources, vec<ExecutionResult>& results, std::ostream& err_out)
+{
+	Program program;
+	if (program.parse(filenames, sources, err_out))
+		return true;
+	program.analyze([&results](const ExecutionResult& res){ results.push_back(res); return true; });
+	return false;
+}
 
-		// temporary placeholder value for a free spot in the algorithm that generates all possible synchronization orders
-		const uint32_t free_slot = std::numeric_limits<uint32_t>::max();
+bool analyze(const vec<std::string>& filenames, const vec<std::istream*>& inputs, vec<ExecutionResult>& results, std::ostream& err_out)
+{
+	const vec<str> contents = read_inputs(inputs);
+	return analyze(filenames, vec<std::string_view>(contents.begin(), contents.end()), results, err_out);
+}
 
-		bool updated = false;
-		for (int32_t i = snps.size() - 2; i >= 0; i--)
-		{
-			// in each iteration, try to advance the places allocated for thread i forward by one (in a particular order of subsets of a given size)
-			// without moving any allocations for threads with lower indices
-			
-			// lowest visited index that is occupied by a thread with an index greater than i
-			int32_t next_free = -1; 
+EngineKernels::EngineKernels(vec<Snippet>& snps)
+	: candidates_left(std::numeric_limits<uint64_t>::max()), ctx(std::make_unique<EngineContext>(snps, sink, candidates_left))
+{
+	find_relevant_reads(*ctx);
+	first_so_thread_alloc(*ctx, so_thread_alloc);
+	build_so(*ctx, so_thread_alloc, nxts, so);
+}
 
-			// number of visited indices occupied by thread i
-			uint32_t self_seen = 0;
+EngineKernels::~EngineKernels() = default;
 
-			// iterate through the indices of the synchronization order back to front
-			for (int32_t j = synaction_count - 1; j >= 0; j--)
-			{
-				if (so_thread_alloc[j] > i)
-					next_free = j;
-				else if (so_thread_alloc[j] == i)
-				{
-					if (next_free != -1)
-					{
-						so_thread_alloc[j] = free_slot;
-						so_thread_alloc[next_free] = i;
-						for (uint32_t k = next_free + 1; self_seen; k++)
-						{
-							if (so_thread_alloc[k] > i)
-							{
-								so_thread_alloc[k] = i;
-								self_seen--;
-							}
-						}
-						updated = true;
-						break;
-					}
-					else
-					{
-						so_thread_alloc[j] = free_slot;
-						self_seen++;
-					}
-				}
-			}
+bool EngineKernels::next_so()
+{
+	const bool advanced = next_so_thread_alloc(so_thread_alloc, ctx->so_units);
+	if (!advanced)
+		first_so_thread_alloc(*ctx, so_thread_alloc);
+	build_so(*ctx, so_thread_alloc, nxts, so);
+	return advanced;
+}
 
-			// after updating the subset of slots allocated for thread i, change the configuration of the threads with indices > i to the minimum
-			
-			if (updated)
-			{
-				uint32_t nxt = 0;
-				for (uint32_t j = i + 1; j < snps.size(); j++)
-				{
-					uint32_t left = synactions[j].size();
-					while (left)
-					{
-						if (so_thread_alloc[nxt] > i)
-						{
-							so_thread_alloc[nxt] = j;
-							left--;
-						}
-						nxt++;
-					}
-				}
-				break;
-			}
-		}
-		if (!updated)
-			break;
-	}
-	return false;
+bool EngineKernels::is_so_well_locked()
+{
+	return JMMExplorer::is_so_well_locked(*ctx, so);
+}
+
+void EngineKernels::compute_happens_before()
+{
+	dispatch_thread_count(*ctx, [this](const auto thread_count){ JMMExplorer::compute_happens_before<decltype(thread_count)::value>(*ctx, so); });
+}
+
+uint64_t EngineKernels::compute_seeable_writes()
+{
+	dispatch_thread_count(*ctx, [this](const auto thread_count){ JMMExplorer::compute_seeable_writes<decltype(thread_count)::value>(*ctx); });
+	uint64_t candidate_count = 1;
+	for (const vec<int32_t>& seeable : ctx->pss_write_seen)
+		candidate_count *= seeable.size();
+	return candidate_count;
 }
 
 }
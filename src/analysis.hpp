@@ -5,12 +5,16 @@
 #include <functional>
 #include <variant>
 #include <iostream>
+#include <string>
+#include <string_view>
 
 #include "vec.hpp"
 
 namespace JMMExplorer
 {
 
+class Snippet;
+
 /// A possible result of an execution of the inputted program when no exception occured
 typedef vec<vec<int32_t>> RegularExecutionResult;
 
@@ -37,8 +41,114 @@ struct ExecutionResult
 	void print(std::ostream& os, const std::function<std::string(uint32_t)>& thread_name_fetcher) const;
 };
 
+/// How an analysis of a Program has ended
+enum class AnalysisStatus
+{
+	/// all the execution results have been reported
+	Completed,
+	/// the result sink has asked to stop
+	Cancelled,
+	/// the candidate budget has run out before all the execution results could be found
+	BudgetExhausted,
+	/// the memory limit has been reached before all the execution results could be found (the ones reported so far are still valid)
+	MemoryExhausted
+};
+
+/// Limits of one analysis of a Program
+struct AnalysisOptions
+{
+	/// Maximal number of write-seen candidates (executions given by a synchronization order and the writes seen by the reads) to be evaluated,
+	/// or of the steps of the interleavings in the sequential consistency mode; 0 means no limit
+	uint64_t candidate_budget = 0;
+
+	/// Approximate number of bytes of distinct execution results kept in memory during the analysis; the rest are spilled to temporary files and
+	/// deduplicated at the end (so they are only reported at the end), 0 means no limit
+	uint64_t result_memory_limit = 256 << 20;
+
+	/// Approximate number of bytes that the major structures of the analysis (its search state, the results kept in memory and the states visited
+	/// in the sequential consistency mode) may use; 0 means no limit
+	/// Getting close to it, the analysis falls back to the cheaper ways: it spills the results to files once they take half of the limit, evaluates
+	/// the candidates with fewer threads and forgets the visited states; when even that isn't enough, it stops with AnalysisStatus::MemoryExhausted
+	uint64_t memory_limit = 0;
+
+	/// Number of threads that evaluate the write-seen candidates of a synchronization order with many of them (like the single one of a program without
+	/// synchronization actions); 0 means as many as the hardware runs at once
+	uint32_t worker_count = 0;
+
+	/// If true, only the sequentially consistent execution results (those of the interleavings of the actions of the threads) are generated, which is much faster
+	bool sequential_consistency = false;
+};
+
+/// Predicted size of the full analysis of a Program (summed over the independent groups of threads, which are analyzed separately)
+struct AnalysisEstimate
+{
+	/// Number of the synchronization orders that the analysis enumerates
+	double so_count = 0;
+
+	/// Number of the synchronization orders sampled and of those of them in which no monitor is locked by two threads at once (the others have no candidates)
+	uint32_t sampled_so_count = 0, well_locked_so_count = 0;
+
+	/// Predicted number of write-seen candidates (the number of synchronization orders times the mean number of candidates of the sampled ones)
+	double candidate_count = 0;
+
+	/// Number of candidates evaluated to measure their cost and the time it took in seconds
+	uint64_t probe_candidate_count = 0;
+	double probe_seconds = 0;
+
+	/// Predicted wall time of the analysis in seconds (from the time per synchronization order measured on the samples and the time per candidate)
+	double seconds = 0;
+};
+
+/// Receives every distinct execution result as soon as it is found; returning false cancels the rest of the analysis
+typedef std::function<bool(const ExecutionResult&)> ResultSink;
+
+/// A program parsed once and prepared for any number of analyses
+class Program
+{
+public:
+	Program();
+	~Program();
+
+	/// Parses every source code into one snippet (thread) named after the corresponding file name and prepares the snippets for the analysis
+	/// Returns true and writes the error messages to err_out if and only if at least one of the snippets was ill formed (incorrect monitor use)
+	bool parse(const vec<std::string>& filenames, const vec<std::string_view>& sources, std::ostream& err_out);
+	/// Returns the number of threads of the program
+	uint32_t get_thread_count() const;
+	/// Returns the name of the thread with the given (zero-based) index
+	const std::string& get_thread_name(uint32_t threadi) const;
+	/// Generates the execution results of the program and passes each distinct one to sink (in the same order as analyze fills its results)
+	AnalysisStatus analyze(const ResultSink& sink, const AnalysisOptions& options = AnalysisOptions());
+	/// Predicts the size of the full (not sequentially consistent) analysis without running it: counts the synchronization orders, samples sample_count of them
+	/// and evaluates a few candidates of every sample to measure the time per candidate
+	AnalysisEstimate estimate(uint32_t sample_count = 64);
+	/// Returns the number of write-seen candidates (or interleaving steps) evaluated by the last analysis
+	uint64_t get_candidate_count() const;
+
+private:
+	// the snippets of all the threads
+	vec<Snippet> snps;
+
+	// groups of threads that don't share any variables or monitors (see find_independent_components in analysis.cpp)
+	vec<vec<uint32_t>> components;
+
+	// if there are at least two components, the snippets of every component (analyzed separately)
+	vec<vec<Snippet>> component_snps;
+
+	// the number of candidates evaluated by the last analysis
+	uint64_t candidate_count = 0;
+};
+
+/// Parses every source code into one snippet named after the corresponding file name
+void parse_snippets(const vec<std::string>& filenames, const vec<std::string_view>& sources, vec<Snippet>& snps);
+
+/// Reads every input and parses it into one snippet named after the corresponding file name
+void parse_snippets(const vec<std::string>& filenames, const vec<std::istream*>& inputs, vec<Snippet>& snps);
+
 /// Generates all possible execution results (that this program is designed to find) of a program consisting of multiple code snippets
 /// Returns true if and only if at least one of the snippets was ill formed (incorrect monitor use)
+bool analyze(const vec<std::string>& filenames, const vec<std::string_view>& sources, vec<ExecutionResult>& results, std::ostream& err_out);
+
+/// Reads the source code of every snippet from the corresponding input and analyzes the program like the overload that takes the source codes
 bool analyze(const vec<std::string>& filenames, const vec<std::istream*>& inputs, vec<ExecutionResult>& results, std::ostream& err_out);
 
 
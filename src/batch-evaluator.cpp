@@ -0,0 +1,183 @@
+#include "batch-evaluator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+namespace JMMExplorer
+{
+
+/// Stores f(a[l], b[l]) into res[l] for every lane l
+template<typename F>
+static void for_lanes(const int32_t* a, const int32_t* b, int32_t* res, const F& f)
+{
+	for (uint32_t l = 0; l < BatchEvaluator::lane_count; l++)
+		res[l] = f(a[l], b[l]);
+}
+
+/// Applies the operation of type op_type on the values in a and b in every lane and stores the results into res; returns the mask of the lanes that divide by zero
+/// (those lanes divide by one instead, so that the loops have no branches)
+static uint32_t apply_arithmetic_lanes(const ArithmeticOpType op_type, const int32_t* a, const int32_t* b, int32_t* res)
+{
+	uint32_t zerodiv = 0;
+	switch (op_type)
+	{
+		case ArithmeticOpType::Add:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return static_cast<uint32_t>(v0) + static_cast<uint32_t>(v1); });
+			break;
+		case ArithmeticOpType::Subtract:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return static_cast<uint32_t>(v0) - static_cast<uint32_t>(v1); });
+			break;
+		case ArithmeticOpType::Multiply:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return static_cast<uint32_t>(v0) * static_cast<uint32_t>(v1); });
+			break;
+		case ArithmeticOpType::Divide:
+		case ArithmeticOpType::Remainder:
+			for (uint32_t l = 0; l < BatchEvaluator::lane_count; l++)
+				zerodiv |= static_cast<uint32_t>(b[l] == 0) << l;
+			// the division is done in 64 bits, so that dividing the minimal int by -1 overflows like in Java instead of trapping
+			if (op_type == ArithmeticOpType::Divide)
+				for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return static_cast<int64_t>(v0) / (v1 != 0 ? v1 : 1); });
+			else
+				for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return static_cast<int64_t>(v0) % (v1 != 0 ? v1 : 1); });
+			break;
+		case ArithmeticOpType::Or:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return v0 | v1; });
+			break;
+		case ArithmeticOpType::Xor:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return v0 ^ v1; });
+			break;
+		case ArithmeticOpType::And:
+			for_lanes(a, b, res, [](const int32_t v0, const int32_t v1){ return v0 & v1; });
+			break;
+	}
+	return zerodiv;
+}
+
+BatchEvaluator::BatchEvaluator(const vec<Snippet>& snps, const vec<std::pair<uint32_t, uint32_t>>& to_thread_action, const vec<uint32_t>& reads)
+	: write_slot(to_thread_action.size()), print_slots(snps.size()), candidates(lane_count)
+{
+	// per-thread action indexing -> global action index and global action index -> read index
+	vec<vec<uint32_t>> to_glob_action(snps.size());
+	for (uint32_t i = 0; i < to_thread_action.size(); i++)
+		to_glob_action[to_thread_action[i].first].push_back(i);
+	vec<uint32_t> read_index(to_thread_action.size());
+	for (uint32_t i = 0; i < reads.size(); i++)
+		read_index[reads[i]] = i;
+
+	vec<vec<DataflowInstruction>> dataflows;
+	uint32_t instruction_count = 0;
+	for (const Snippet& snp : snps)
+	{
+		dataflows.push_back(snp.get_dataflow());
+		instruction_count += dataflows.back().size();
+	}
+
+	// literal value -> its slot
+	std::unordered_map<int32_t, uint32_t> literal_slots;
+	vec<int32_t> literals;
+	const auto literal_slot = [&](const int32_t literal)
+	{
+		const auto it = literal_slots.find(literal);
+		if (it != literal_slots.end())
+			return it->second;
+		literals.push_back(literal);
+		return literal_slots[literal] = instruction_count + literals.size() - 1;
+	};
+	zero_slot = literal_slot(0);
+
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		const uint32_t base = code.size();
+		for (const DataflowInstruction& di : dataflows[i])
+		{
+			const uint32_t slot = code.size();
+			const auto operand_slot = [&](const uint32_t opi)
+			{
+				return di.source[opi] != -1 ? base + di.source[opi] : literal_slot(di.literal[opi]);
+			};
+			Operation op{ di.kind, di.op_type, 0, 0 };
+			if (di.kind == DataflowInstruction::Kind::Read)
+				op.arg0 = read_index[to_glob_action[i][di.action_index]];
+			else if (di.kind == DataflowInstruction::Kind::Copy || di.kind == DataflowInstruction::Kind::Arithmetic)
+			{
+				op.arg0 = operand_slot(0);
+				op.arg1 = di.kind == DataflowInstruction::Kind::Arithmetic ? operand_slot(1) : 0;
+				if (di.kind == DataflowInstruction::Kind::Copy && di.action_index != -1)
+					write_slot[to_glob_action[i][di.action_index]] = slot;
+			}
+			if (di.is_print)
+				print_slots[i].push_back(slot);
+			code.push_back(op);
+		}
+	}
+
+	values.resize((instruction_count + literals.size()) * lane_count);
+	for (uint32_t i = 0; i < literals.size(); i++)
+		std::fill_n(&values[(instruction_count + i) * lane_count], lane_count, literals[i]);
+	seen_slot.assign(reads.size() * lane_count, zero_slot);
+	read_values.resize(reads.size() * lane_count);
+}
+
+void BatchEvaluator::set_candidate(const uint32_t lane, const vec<int32_t>& write_seen)
+{
+	candidates[lane] = write_seen;
+	for (uint32_t i = 0; i < write_seen.size(); i++)
+		seen_slot[i * lane_count + lane] = write_seen[i] != -1 ? write_slot[write_seen[i]] : zero_slot;
+}
+
+const vec<int32_t>& BatchEvaluator::get_candidate(const uint32_t lane) const
+{
+	return candidates[lane];
+}
+
+uint32_t BatchEvaluator::evaluate(const uint32_t lanes)
+{
+	std::fill(read_values.begin(), read_values.end(), 0);
+	for (uint32_t round = 0; ; round++)
+	{
+		// without dependency cycles, a read that (transitively) depends on k other reads has its final value after round k
+		assert(round <= read_values.size() / lane_count + 1);
+
+		// lanes in which some instruction divided by zero in this round (only the last round, which evaluates with the final read values, counts)
+		uint32_t zerodiv = 0;
+		for (uint32_t i = 0; i < code.size(); i++)
+		{
+			const Operation& op = code[i];
+			int32_t* const res = &values[i * lane_count];
+			switch (op.kind)
+			{
+				case DataflowInstruction::Kind::NoValue:
+					break;
+				case DataflowInstruction::Kind::Read:
+					std::copy_n(&read_values[op.arg0 * lane_count], lane_count, res);
+					break;
+				case DataflowInstruction::Kind::Copy:
+					std::copy_n(&values[op.arg0 * lane_count], lane_count, res);
+					break;
+				case DataflowInstruction::Kind::Arithmetic:
+					zerodiv |= apply_arithmetic_lanes(op.op_type, &values[op.arg0 * lane_count], &values[op.arg1 * lane_count], res);
+					break;
+			}
+		}
+
+		bool changed = false;
+		for (uint32_t i = 0; i < read_values.size(); i++)
+		{
+			const int32_t val = values[seen_slot[i] * lane_count + i % lane_count];
+			changed |= val != read_values[i];
+			read_values[i] = val;
+		}
+		if (!changed)
+			return zerodiv & ((1u << lanes) - 1);
+	}
+}
+
+void BatchEvaluator::get_execution_results(const uint32_t lane, int32_t* ress) const
+{
+	for (const vec<uint32_t>& slots : print_slots)
+		for (const uint32_t slot : slots)
+			*ress++ = values[slot * lane_count + lane];
+}
+
+}
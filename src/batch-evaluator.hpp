@@ -0,0 +1,76 @@
+#ifndef BATCH_EVALUATOR_HPP
+#define BATCH_EVALUATOR_HPP
+
+#include <cstdint>
+#include <utility>
+
+#include "snippet.hpp"
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+/// Evaluates the executions of a program for up to lane_count write-seen candidates at once
+/// The values of one instruction in all the candidates (lanes) are stored next to each other, so that every instruction is computed by a short loop over the lanes
+/// which the compiler vectorizes; the reads get their values by repeatedly evaluating the whole program until no read changes, which terminates for candidates
+/// without dependency cycles
+class BatchEvaluator
+{
+public:
+	/// Number of candidates evaluated at once
+	static constexpr uint32_t lane_count = 8;
+
+	/// Prepares the evaluation of the program consisting of snps (their preexecution analysis must have been run already); the write-seen candidates
+	/// refer to the actions by the global indices given by to_thread_action and reads[i] is the global index of the read with index i
+	BatchEvaluator(const vec<Snippet>& snps, const vec<std::pair<uint32_t, uint32_t>>& to_thread_action, const vec<uint32_t>& reads);
+
+	/// Stores write_seen (for each read, the global index of the write it sees or -1 for the initial write) as the candidate evaluated in lane number lane
+	void set_candidate(uint32_t lane, const vec<int32_t>& write_seen);
+	/// Returns the candidate stored in lane number lane
+	const vec<int32_t>& get_candidate(uint32_t lane) const;
+	/// Evaluates the candidates in the first lanes lanes, none of which may have a dependency cycle; returns the mask of the lanes (bit i for lane i)
+	/// in which some instruction divides by zero, the results of those lanes aren't valid and have to be found by the scalar evaluation in the snippets
+	uint32_t evaluate(uint32_t lanes);
+	/// Assuming evaluate has been run, stores the values printed by all the snippets in the execution in lane number lane into ress[0], ress[1], ...
+	/// (the values of every snippet in the order of its prints, one snippet after another)
+	void get_execution_results(uint32_t lane, int32_t* ress) const;
+
+private:
+	// one instruction whose operands are given by the index of the slot (a row of lane_count values) holding their values
+	struct Operation
+	{
+		DataflowInstruction::Kind kind;
+		ArithmeticOpType op_type;
+
+		// slots of the operands; for a read, arg0 is the index of the read instead
+		uint32_t arg0, arg1;
+	};
+
+	// the instructions of all the snippets one after another; instruction i stores its values into slot i
+	vec<Operation> code;
+
+	// the slots after the instructions hold literals (the same value in every lane); this is the slot with zero
+	uint32_t zero_slot;
+
+	// for each global action index of a write, the slot of the write
+	vec<uint32_t> write_slot;
+
+	// for each snippet, the slots of its prints
+	vec<vec<uint32_t>> print_slots;
+
+	// the candidate of each lane
+	vec<vec<int32_t>> candidates;
+
+	// value at index rix * lane_count + lane is the slot of the write seen by read rix in the candidate in lane
+	vec<uint32_t> seen_slot;
+
+	// value at index slot * lane_count + lane is the value in the slot in the execution in lane
+	vec<int32_t> values;
+
+	// value at index rix * lane_count + lane is the value supplied to read rix in the execution in lane
+	vec<int32_t> read_values;
+};
+
+}
+
+#endif // BATCH_EVALUATOR_HPP
@@ -0,0 +1,167 @@
+#include "benchmarking.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include "analysis.hpp"
+#include "engine-kernels.hpp"
+#include "result-store.hpp"
+#include "snippet.hpp"
+
+/// Number of memory allocations done by the whole program so far (this file is only linked into the benchmarks, so only they count the allocations)
+static std::atomic<uint64_t> allocation_count(0);
+
+void* operator new(const std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if (void *const ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *const ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *const ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace JMMExplorer
+{
+
+/// Returns the source code of thread threadi of the synthetic program: its statements cycle through a shared read, a shared write that depends on it,
+/// a critical section with a volatile write and a print that depends on a volatile read, all on variables and a monitor shared by all the threads
+static std::string synthetic_source(const uint32_t threadi, const uint32_t size)
+{
+	std::string source;
+	for (uint32_t j = 0; j < size; j++)
+	{
+		const std::string local = "l" + std::to_string(j - j % 4);
+		switch (j % 4)
+		{
+			case 0:
+				source += local + "=sa+" + std::to_string(threadi) + ";\n";
+				break;
+			case 1:
+				source += "sb=" + local + "*2;\n";
+				break;
+			case 2:
+				source += "m.lock();va=sb;m.unlock();\n";
+				break;
+			case 3:
+				source += "print(" + local + "+vb);\n";
+				break;
+		}
+	}
+	return source;
+}
+
+/// Runs body(i) for i = 0, 1, ... (the number of calls is doubled until they take long enough to be measured reliably)
+/// and prints the time and the number of allocations per call under the given name
+template<typename F>
+static void measure(const char *const name, const F& body)
+{
+	const auto min_duration = std::chrono::milliseconds(200);
+	for (uint64_t ops = 1; ; ops *= 2)
+	{
+		const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+		const auto start = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < ops; i++)
+			body(i);
+		const auto duration = std::chrono::steady_clock::now() - start;
+		const uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+		if (duration >= min_duration)
+		{
+			std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+				<< std::setw(14) << std::setprecision(1) << std::chrono::duration<double, std::nano>(duration).count() / ops << " ns/op"
+				<< std::setw(12) << std::setprecision(3) << static_cast<double>(allocations) / ops << " allocs/op\n";
+			return;
+		}
+	}
+}
+
+void run_all_benchmarks(const uint32_t size)
+{
+	const uint32_t thread_count = 3;
+	vec<std::string> filenames, sources;
+	for (uint32_t i = 0; i < thread_count; i++)
+	{
+		filenames.push_back("thread " + std::to_string(i));
+		sources.push_back(synthetic_source(i, size));
+	}
+	vec<Snippet> snps;
+	parse_snippets(filenames, vec<std::string_view>(sources.begin(), sources.end()), snps);
+	for (Snippet& snp : snps)
+	{
+		snp.optimize();
+		snp.run_preexecution_analysis();
+	}
+	std::cout << "[[ " << thread_count << " THREADS WITH " << size << " STATEMENTS EACH ]]\n";
+
+	// keeps the results of the benchmarked code alive, so that the compiler can't leave it out
+	uint64_t checksum = 0;
+
+	// one op is the evaluation of every write and print of the program with new values of the reads
+	vec<vec<int32_t>> ress;
+	for (const Snippet& snp : snps)
+		ress.emplace_back(snp.print_count());
+	measure("evaluation", [&](const uint64_t i)
+	{
+		for (uint32_t j = 0; j < snps.size(); j++)
+		{
+			Snippet& snp = snps[j];
+			snp.prepare_execution();
+			for (uint32_t k = 0; k < snp.action_count(); k++)
+			{
+				const Instruction& action = snp.get_action(k);
+				if (action.is_read())
+					snp.supply_read_value(k, i + k);
+				else if (action.is_write())
+					checksum += snp.read_write(k);
+			}
+			snp.get_execution_results(ress[j].data());
+			checksum += ress[j].empty() ? 0 : ress[j].back();
+		}
+	});
+
+	EngineKernels kernels(snps);
+	measure("so successor", [&](uint64_t)
+	{
+		checksum += kernels.next_so();
+	});
+	measure("so monitor check", [&](uint64_t)
+	{
+		checksum += kernels.is_so_well_locked();
+	});
+	measure("happens-before", [&](uint64_t)
+	{
+		kernels.compute_happens_before();
+	});
+	measure("seeable writes", [&](uint64_t)
+	{
+		checksum += kernels.compute_seeable_writes();
+	});
+
+	// one op is looking up a result that has already been found among size distinct results
+	vec<ExecutionResult> pool;
+	for (uint32_t i = 0; i < std::max(size, 1u); i++)
+		pool.push_back({ RegularExecutionResult(thread_count, vec<int32_t>(size / 4 + 1, i)) });
+	ResultStore results(vec<uint32_t>(thread_count, size / 4 + 1), 0);
+	for (const ExecutionResult& res : pool)
+		results.add(res);
+	measure("result dedup", [&](const uint64_t i)
+	{
+		checksum += results.add(pool[i % pool.size()]);
+	});
+
+	std::cout << "checksum " << checksum << "\n";
+}
+
+}
@@ -0,0 +1,15 @@
+#ifndef BENCHMARKING_HPP
+#define BENCHMARKING_HPP
+
+#include <cstdint>
+
+namespace JMMExplorer
+{
+
+/// Runs the micro-benchmarks of the individual steps of the analysis on a synthetic program whose threads have size statements each
+/// and prints the time and the number of memory allocations per operation of every benchmark to standard output
+void run_all_benchmarks(uint32_t size);
+
+}
+
+#endif // BENCHMARKING_HPP
@@ -0,0 +1,93 @@
+#include "canonical.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <sstream>
+
+namespace JMMExplorer
+{
+
+ExecutionResult CanonicalProgram::to_original(const ExecutionResult& canonical_result) const
+{
+	if (std::holds_alternative<RegularExecutionResult>(canonical_result.result))
+	{
+		const RegularExecutionResult& cres = std::get<RegularExecutionResult>(canonical_result.result);
+		RegularExecutionResult res(cres.size());
+		for (uint32_t i = 0; i < cres.size(); i++)
+			res[thread_order[i]] = cres[i];
+		return { res };
+	}
+	const ExceptedExecutionResult& cres = std::get<ExceptedExecutionResult>(canonical_result.result);
+	const uint32_t thread = thread_order[cres.ex_thread];
+	assert(cres.ex_line >= 1 && cres.ex_line <= line_maps[thread].size());
+	return { ExceptedExecutionResult{ thread, line_maps[thread][cres.ex_line - 1] } };
+}
+
+ExecutionResult CanonicalProgram::to_canonical(const ExecutionResult& original_result) const
+{
+	if (std::holds_alternative<RegularExecutionResult>(original_result.result))
+	{
+		const RegularExecutionResult& ores = std::get<RegularExecutionResult>(original_result.result);
+		RegularExecutionResult res(ores.size());
+		for (uint32_t i = 0; i < ores.size(); i++)
+			res[thread_position[i]] = ores[i];
+		return { res };
+	}
+	const ExceptedExecutionResult& ores = std::get<ExceptedExecutionResult>(original_result.result);
+	const vec<uint32_t>& line_map = line_maps[ores.ex_thread];
+	const auto it = std::find(line_map.begin(), line_map.end(), ores.ex_line);
+	assert(it != line_map.end());
+	return { ExceptedExecutionResult{ thread_position[ores.ex_thread], static_cast<uint32_t>(it - line_map.begin() + 1) } };
+}
+
+/// Returns the canonical name of the index-th distinct global object whose original name is original_name
+static Ident canonical_global_name(const Ident& original_name, const size_t index)
+{
+	// the first character determines the kind of the object, so it has to be kept
+	return original_name.substr(0, 1) + std::to_string(index);
+}
+
+CanonicalProgram canonicalize(const vec<Snippet>& snps)
+{
+	CanonicalProgram can;
+	can.line_maps.resize(snps.size());
+
+	// a signature of each thread that doesn't depend on the names used, computed by renaming the global objects in the order of first use within the thread only
+	vec<str> signatures(snps.size());
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		const vec<Ident> names = snps[i].get_global_names();
+		std::ostringstream ss;
+		snps[i].print_canonical(ss, [&names](const Ident& name)
+		{
+			return canonical_global_name(name, std::find(names.begin(), names.end(), name) - names.begin());
+		}, can.line_maps[i]);
+		signatures[i] = ss.str();
+	}
+
+	can.thread_order.resize(snps.size());
+	std::iota(can.thread_order.begin(), can.thread_order.end(), 0);
+	std::stable_sort(can.thread_order.begin(), can.thread_order.end(), [&signatures](const uint32_t a, const uint32_t b){ return signatures[a] < signatures[b]; });
+	can.thread_position.resize(snps.size());
+	for (uint32_t i = 0; i < snps.size(); i++)
+		can.thread_position[can.thread_order[i]] = i;
+
+	// number the global objects in the order of first use in the canonically ordered threads
+	size_t next_global = 0;
+	for (const uint32_t threadi : can.thread_order)
+		for (const Ident& name : snps[threadi].get_global_names())
+			if (can.global_names.find(name) == can.global_names.end())
+				can.global_names[name] = canonical_global_name(name, next_global++);
+
+	std::ostringstream ss;
+	for (const uint32_t threadi : can.thread_order)
+	{
+		ss << "thread\n";
+		snps[threadi].print_canonical(ss, [&can](const Ident& name){ return can.global_names.at(name); }, can.line_maps[threadi]);
+	}
+	can.key = ss.str();
+	return can;
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef CANONICAL_HPP
+#define CANONICAL_HPP
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "analysis.hpp"
+#include "snippet.hpp"
+#include "str.hpp"
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+/// Canonical form of a program (a set of snippets) that doesn't depend on the names of the variables and monitors or on the order of the threads
+/// Two programs with the same key are equal up to renaming and reordering of the threads, and so they have the same execution results up to the
+/// translation done by to_original and to_canonical
+/// (the canonical thread order is only guaranteed to be found up to threads whose instructions look the same, so two such programs can rarely get different keys)
+struct CanonicalProgram
+{
+	/// Textual representation of the whole program after renaming and thread reordering
+	str key;
+
+	/// Index i holds the index of the original thread that comes i-th in the canonical thread order
+	vec<uint32_t> thread_order;
+
+	/// Index i holds the position of the original thread i in the canonical thread order
+	vec<uint32_t> thread_position;
+
+	/// Maps the name of every shared variable, volatile variable and monitor of the original program to its canonical name
+	std::unordered_map<Ident, Ident> global_names;
+
+	/// For each original thread, index k holds the original line number of the canonical line k + 1 (only lines that can cause an exception are renumbered)
+	vec<vec<uint32_t>> line_maps;
+
+	/// Translates an execution result of the canonical program into the corresponding execution result of the original program
+	ExecutionResult to_original(const ExecutionResult& canonical_result) const;
+
+	/// Translates an execution result of the original program into the corresponding execution result of the canonical program
+	ExecutionResult to_canonical(const ExecutionResult& original_result) const;
+};
+
+/// Computes the canonical form of the program consisting of the given snippets
+CanonicalProgram canonicalize(const vec<Snippet>& snps);
+
+}
+
+#endif // CANONICAL_HPP
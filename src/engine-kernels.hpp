@@ -0,0 +1,47 @@
+#ifndef ENGINE_KERNELS_HPP
+#define ENGINE_KERNELS_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include "analysis.hpp"
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+struct EngineContext;
+
+/// Gives access to the individual steps of the analysis of a program one by one, so that they can be measured separately by the micro-benchmarks
+class EngineKernels
+{
+public:
+	/// Prepares the analysis of the program consisting of snps (their preexecution analysis must have been run already) and sets the first synchronization order
+	EngineKernels(vec<Snippet>& snps);
+	~EngineKernels();
+
+	/// Moves to the next synchronization order (to the first one again after the last one); returns false iff it has started again
+	bool next_so();
+	/// Returns true iff no monitor is locked in the current synchronization order while another thread holds it
+	bool is_so_well_locked();
+	/// Computes the happens-before order of the current synchronization order
+	void compute_happens_before();
+	/// Computes the writes that every shared read can see (compute_happens_before must have been run for the current synchronization order);
+	/// returns the number of the write-seen candidates
+	uint64_t compute_seeable_writes();
+
+private:
+	// the sink and the budget of the context (neither is used)
+	ResultSink sink;
+	uint64_t candidates_left;
+
+	// the engine state
+	std::unique_ptr<EngineContext> ctx;
+
+	// the current synchronization order, its allocation to the threads and the scratch buffer for building it
+	vec<uint32_t> so_thread_alloc, so, nxts;
+};
+
+}
+
+#endif // ENGINE_KERNELS_HPP
@@ -0,0 +1,82 @@
+#include "flat-interner.hpp"
+
+#include <algorithm>
+
+namespace JMMExplorer
+{
+
+/// Initial number of slots of the hash table
+static constexpr uint32_t initial_slot_count = 16;
+
+FlatInterner::FlatInterner(const uint32_t width)
+	: width(width), slots(initial_slot_count, 0)
+{
+}
+
+size_t FlatInterner::hash(const int32_t* const key) const
+{
+	uint64_t h = 0x9e3779b97f4a7c15;
+	for (uint32_t i = 0; i < width; i++)
+		h = (h ^ static_cast<uint32_t>(key[i])) * 0x100000001b3;
+	return h ^ (h >> 29);
+}
+
+uint32_t FlatInterner::intern(const int32_t* const key, bool& inserted)
+{
+	const size_t mask = slots.size() - 1;
+	for (size_t slot = hash(key) & mask; ; slot = (slot + 1) & mask)
+	{
+		if (slots[slot] == 0)
+		{
+			keys.insert(keys.end(), key, key + width);
+			slots[slot] = ++count;
+			// the table is kept at most half full
+			if (2 * count > slots.size())
+				grow();
+			inserted = true;
+			return count - 1;
+		}
+		if (std::equal(key, key + width, get(slots[slot] - 1)))
+		{
+			inserted = false;
+			return slots[slot] - 1;
+		}
+	}
+}
+
+const int32_t* FlatInterner::get(const uint32_t id) const
+{
+	return keys.data() + static_cast<size_t>(id) * width;
+}
+
+uint32_t FlatInterner::size() const
+{
+	return count;
+}
+
+uint64_t FlatInterner::memory_use() const
+{
+	return keys.capacity() * sizeof(int32_t) + slots.capacity() * sizeof(uint32_t);
+}
+
+void FlatInterner::clear()
+{
+	keys.clear();
+	std::fill(slots.begin(), slots.end(), 0);
+	count = 0;
+}
+
+void FlatInterner::grow()
+{
+	slots.assign(slots.size() * 2, 0);
+	const size_t mask = slots.size() - 1;
+	for (uint32_t id = 0; id < count; id++)
+	{
+		size_t slot = hash(get(id)) & mask;
+		while (slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		slots[slot] = id + 1;
+	}
+}
+
+}
@@ -0,0 +1,54 @@
+#ifndef FLAT_INTERNER_HPP
+#define FLAT_INTERNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+/// Assigns consecutive ids (starting at 0) to distinct keys that all consist of the same number of int32_t values
+/// The keys are stored one after another in a single buffer and found through an open-addressing hash table of their ids,
+/// so that looking up a key that is already there never allocates memory
+class FlatInterner
+{
+public:
+	/// Constructs an empty interner of keys of width values each
+	FlatInterner(uint32_t width);
+
+	/// Returns the id of the key whose values start at key, adding the key if it isn't there yet; sets inserted to true iff it has been added
+	uint32_t intern(const int32_t* key, bool& inserted);
+	/// Returns the values of the key with the given id
+	const int32_t* get(uint32_t id) const;
+	/// Returns the number of the keys
+	uint32_t size() const;
+	/// Returns the number of bytes of memory used by the keys and the hash table
+	uint64_t memory_use() const;
+	/// Removes all the keys
+	void clear();
+
+private:
+	// number of values of every key
+	uint32_t width;
+
+	// the values of all the keys in the order of their ids
+	vec<int32_t> keys;
+
+	// the hash table: every slot holds an id increased by one or 0 if it is empty (its size is a power of two)
+	vec<uint32_t> slots;
+
+	// number of the keys
+	uint32_t count = 0;
+
+	// returns the hash of the key whose values start at key
+	size_t hash(const int32_t* key) const;
+
+	// doubles the size of the hash table
+	void grow();
+};
+
+}
+
+#endif // FLAT_INTERNER_HPP
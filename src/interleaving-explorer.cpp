@@ -0,0 +1,204 @@
+#include "interleaving-explorer.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace JMMExplorer
+{
+
+InterleavingExplorer::InterleavingExplorer(vec<Snippet>& snps)
+	: snps(snps), object_of(snps.size()), relevant_read(snps.size()), pc(snps.size(), 0), reads_done(snps.size()), print_offsets(1, 0)
+{
+	for (const Snippet& snp : snps)
+		print_offsets.push_back(print_offsets.back() + snp.print_count());
+	newout.resize(print_offsets.back());
+
+	// variables and monitors are numbered separately, in the order of their first use
+	std::unordered_map<Ident, uint32_t> variable_ids, monitor_ids;
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		const Snippet& snp = snps[i];
+		object_of[i].resize(snp.action_count(), 0);
+		relevant_read[i].resize(snp.action_count(), false);
+		for (uint32_t k = 0; k < snp.action_count(); k++)
+		{
+			const Instruction& action = snp.get_action(k);
+			if (action.is_lock() || action.is_unlock())
+				object_of[i][k] = monitor_ids.emplace(action.get_monitor_name(), monitor_ids.size()).first->second;
+			else
+			{
+				const Ident name = action.is_shared_read() || action.is_shared_write() ? action.get_shared_name() : action.get_volatile_name();
+				object_of[i][k] = variable_ids.emplace(name, variable_ids.size()).first->second;
+				if (action.is_write())
+					for (const uint32_t readi : snp.get_write_dependencies(k))
+						relevant_read[i][readi] = true;
+			}
+		}
+		for (const uint32_t readi : snp.get_output_dependencies())
+			relevant_read[i][readi] = true;
+	}
+	memory.resize(variable_ids.size());
+	owner.resize(monitor_ids.size());
+	lock_count.resize(monitor_ids.size());
+}
+
+AnalysisStatus InterleavingExplorer::explore(ResultStore& results, const ResultSink& sink, uint64_t& steps_left, const uint64_t memory_limit)
+{
+	this->results = &results;
+	this->sink = &sink;
+	this->steps_left = &steps_left;
+	this->memory_limit = memory_limit;
+	status = AnalysisStatus::Completed;
+	std::fill(pc.begin(), pc.end(), 0);
+	std::fill(memory.begin(), memory.end(), 0);
+	std::fill(owner.begin(), owner.end(), -1);
+	std::fill(lock_count.begin(), lock_count.end(), 0);
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		snps[i].prepare_execution();
+		reads_done[i].clear();
+	}
+	visited.clear();
+	visited_memory_use = 0;
+
+	explore_state();
+	return status;
+}
+
+str InterleavingExplorer::state_key() const
+{
+	str key;
+	const auto append = [&key](const int32_t value)
+	{
+		key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+	for (const uint32_t p : pc)
+		append(p);
+	for (const int32_t value : memory)
+		append(value);
+	for (uint32_t m = 0; m < owner.size(); m++)
+	{
+		append(owner[m]);
+		append(lock_count[m]);
+	}
+	// the reads that nothing depends on can't change the rest of the execution
+	for (uint32_t i = 0; i < snps.size(); i++)
+		for (const std::pair<uint32_t, int32_t>& read : reads_done[i])
+			if (relevant_read[i][read.first])
+				append(read.second);
+	return key;
+}
+
+void InterleavingExplorer::add_result(const ExecutionResult& res)
+{
+	if (results->add(res) && *sink && !(*sink)(res))
+		status = AnalysisStatus::Cancelled;
+}
+
+void InterleavingExplorer::report_exception(const uint32_t threadi)
+{
+	Snippet& snp = snps[threadi];
+	add_result({ ExceptedExecutionResult{ threadi, snp.get_excepted_line() } });
+	snp.prepare_execution();
+	for (const std::pair<uint32_t, int32_t>& read : reads_done[threadi])
+		snp.supply_read_value(read.first, read.second);
+}
+
+void InterleavingExplorer::explore_state()
+{
+	const auto inserted = visited.insert(state_key());
+	if (!inserted.second)
+		return;
+
+	// the key, the node of the hash table and its bucket
+	visited_memory_use += inserted.first->size() + sizeof(str) + 3 * sizeof(void*);
+	if (memory_limit && visited_memory_use + results->memory_use() > memory_limit)
+	{
+		if (results->memory_use() > memory_limit)
+		{
+			status = AnalysisStatus::MemoryExhausted;
+			return;
+		}
+		visited.clear();
+		visited_memory_use = 0;
+	}
+
+	bool finished = true;
+	for (uint32_t i = 0; i < snps.size() && status == AnalysisStatus::Completed; i++)
+	{
+		Snippet& snp = snps[i];
+		if (pc[i] == snp.action_count())
+			continue;
+		finished = false;
+
+		const uint32_t k = pc[i];
+		const Instruction& action = snp.get_action(k);
+		const uint32_t obj = object_of[i][k];
+		if (action.is_lock() && owner[obj] != -1 && owner[obj] != static_cast<int32_t>(i))
+			continue;
+		if (*steps_left == 0)
+		{
+			status = AnalysisStatus::BudgetExhausted;
+			return;
+		}
+		(*steps_left)--;
+
+		// perform the action, explore the rest and undo the action
+		pc[i]++;
+		if (action.is_lock())
+		{
+			owner[obj] = i;
+			lock_count[obj]++;
+			explore_state();
+			if (--lock_count[obj] == 0)
+				owner[obj] = -1;
+		}
+		else if (action.is_unlock())
+		{
+			if (--lock_count[obj] == 0)
+				owner[obj] = -1;
+			explore_state();
+			owner[obj] = i;
+			lock_count[obj]++;
+		}
+		else if (action.is_read())
+		{
+			snp.supply_read_value(k, memory[obj]);
+			reads_done[i].emplace_back(k, memory[obj]);
+			explore_state();
+			reads_done[i].pop_back();
+			snp.invalidate_read_dependents(k);
+		}
+		else
+		{
+			const int32_t value = snp.read_write(k);
+			if (snp.is_zerodiv_excepted())
+				report_exception(i);
+			else
+			{
+				const int32_t old_value = memory[obj];
+				memory[obj] = value;
+				explore_state();
+				memory[obj] = old_value;
+			}
+		}
+		pc[i]--;
+	}
+	if (!finished)
+		return;
+
+	// all the actions have been performed, so the prints can be evaluated
+	for (uint32_t i = 0; i < snps.size(); i++)
+	{
+		snps[i].get_execution_results(&newout[print_offsets[i]]);
+		if (snps[i].is_zerodiv_excepted())
+		{
+			report_exception(i);
+			return;
+		}
+	}
+	if (results->add_flat(newout.data()) && *sink && !(*sink)({ results->unflatten(newout.data()) }))
+		status = AnalysisStatus::Cancelled;
+}
+
+}
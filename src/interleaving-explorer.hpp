@@ -0,0 +1,90 @@
+#ifndef INTERLEAVING_EXPLORER_HPP
+#define INTERLEAVING_EXPLORER_HPP
+
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+
+#include "analysis.hpp"
+#include "result-store.hpp"
+#include "snippet.hpp"
+#include "str.hpp"
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+/// Finds the sequentially consistent execution results of a program by enumerating the interleavings of the actions of its threads
+/// Every action reads or writes the single current value of a variable (volatile or not); the search is a depth-first search whose state
+/// (the position in every thread, the memory, the monitor owners and the read values that the rest of the execution depends on) is updated
+/// and undone step by step and every state is explored only once
+class InterleavingExplorer
+{
+public:
+	/// Prepares the exploration of the program consisting of snps (their preexecution analysis must have been run already)
+	InterleavingExplorer(vec<Snippet>& snps);
+
+	/// Adds every execution result to results and passes the ones it reports as new to sink (if it isn't empty); at most steps_left
+	/// steps (actions performed in some interleaving) are taken and it is decreased accordingly
+	/// Once the visited states and the results take more than about memory_limit bytes (0 means no limit), the visited states are forgotten
+	/// (so some states may be explored again); if the results alone take more, the exploration stops
+	AnalysisStatus explore(ResultStore& results, const ResultSink& sink, uint64_t& steps_left, uint64_t memory_limit = 0);
+
+private:
+	// the snippets (threads) of the program
+	vec<Snippet>& snps;
+
+	// for each thread and action index, the index of the variable or the monitor of the action (or 0 if it has neither)
+	vec<vec<uint32_t>> object_of;
+
+	// for each thread and action index, true iff the action is a read whose value a later write or a print of the thread depends on
+	vec<vec<uint8_t>> relevant_read;
+
+	// for each thread, the index of its next action
+	vec<uint32_t> pc;
+
+	// the current value of every variable
+	vec<int32_t> memory;
+
+	// for each monitor, the thread that holds it or -1 and how many times it holds it
+	vec<int32_t> owner;
+	vec<uint32_t> lock_count;
+
+	// for each thread, the action indices and the values of all the reads it has performed so far
+	vec<vec<std::pair<uint32_t, int32_t>>> reads_done;
+
+	// the keys of the states that have already been explored and the approximate number of bytes they take
+	std::unordered_set<str> visited;
+	uint64_t visited_memory_use = 0;
+
+	// for each thread, the index of its first printed value in newout (with the total number of printed values at the end)
+	vec<uint32_t> print_offsets;
+
+	// the values printed by all the threads, one thread after another
+	vec<int32_t> newout;
+
+	// where the results are collected
+	ResultStore* results;
+	const ResultSink* sink;
+	uint64_t* steps_left;
+	uint64_t memory_limit;
+
+	// how the exploration ends
+	AnalysisStatus status;
+
+	// returns the key of the current state
+	str state_key() const;
+
+	// adds res to the results and passes it to the sink if the results report it as new
+	void add_result(const ExecutionResult& res);
+
+	// reports the exception of thread threadi and brings its snippet back into the state given by reads_done
+	void report_exception(uint32_t threadi);
+
+	// explores all the interleavings of the remaining actions from the current state
+	void explore_state();
+};
+
+}
+
+#endif // INTERLEAVING_EXPLORER_HPP
@@ -5,6 +5,43 @@
 namespace JMMExplorer
 {
 
+bool apply_arithmetic(const ArithmeticOpType op_type, const int32_t v0, const int32_t v1, int32_t& res)
+{
+	switch (op_type)
+	{
+		case ArithmeticOpType::Add:
+			res = static_cast<uint32_t>(v0) + static_cast<uint32_t>(v1);
+			return true;
+		case ArithmeticOpType::Subtract:
+			res = static_cast<uint32_t>(v0) - static_cast<uint32_t>(v1);
+			return true;
+		case ArithmeticOpType::Multiply:
+			res = static_cast<uint32_t>(v0) * static_cast<uint32_t>(v1);
+			return true;
+		case ArithmeticOpType::Divide:
+			if (v1 == 0)
+				return false;
+			res = static_cast<int64_t>(v0) / v1;
+			return true;
+		case ArithmeticOpType::Remainder:
+			if (v1 == 0)
+				return false;
+			res = static_cast<int64_t>(v0) % v1;
+			return true;
+		case ArithmeticOpType::Or:
+			res = v0 | v1;
+			return true;
+		case ArithmeticOpType::Xor:
+			res = v0 ^ v1;
+			return true;
+		case ArithmeticOpType::And:
+			res = v0 & v1;
+			return true;
+	}
+	assert(false);
+	return false;
+}
+
 str get_mnemonic(ArithmeticOpType op_type)
 {
 	switch (op_type)
@@ -1,6 +1,7 @@
 #ifndef JMME_LANGUAGE_HPP
 #define JMME_LANGUAGE_HPP
 
+#include <cstdint>
 #include <string>
 
 #include "location.hh"
@@ -18,6 +19,10 @@ enum class ArithmeticOpType
 	Add, Subtract, Multiply, Divide, Remainder, Or, Xor, And
 };
 
+/// Computes the result of the arithmetic operation of type op_type on v0 and v1 with the semantics of Java ints and stores it in res
+/// Returns false (and leaves res unchanged) if and only if the operation causes a division by zero exception
+bool apply_arithmetic(ArithmeticOpType op_type, int32_t v0, int32_t v1, int32_t& res);
+
 /// Returns the short mnemonic of the given arithmetic instruction used when the generated instructions need to be printed out
 str get_mnemonic(ArithmeticOpType op_type);
 
@@ -0,0 +1,182 @@
+#include "jmme-scanner.hpp"
+
+#include <limits>
+
+namespace JMMExplorer
+{
+
+/// Returns true iff c can start an identifier
+static bool is_ident_start(const char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '$' || c == '_';
+}
+
+/// Returns true iff c is a decimal digit
+static bool is_digit(const char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+/// Returns true iff c is a whitespace character that separates tokens
+static bool is_space(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\v' || c == '\r' || c == '\n';
+}
+
+/// Returns true iff c can start some token
+static bool starts_token(const char c)
+{
+	switch (c)
+	{
+		case ';': case '+': case '-': case '*': case '/': case '%': case '&': case '^': case '|': case '(': case ')': case '.': case '=':
+			return true;
+		default:
+			return is_ident_start(c) || is_digit(c);
+	}
+}
+
+JMMEScanner::JMMEScanner(const std::string_view text, std::ostream& err_out)
+	: cur(text.data()), end(text.data() + text.size()), err_out(err_out)
+{
+}
+
+std::ostream& JMMEScanner::get_err_out() const
+{
+	return err_out;
+}
+
+void JMMEScanner::report_unrecognized(const char *const begin) const
+{
+	if (cur - begin == 1)
+		err_out << "Unrecognized character \'" << *begin << "\'." << std::endl;
+	else
+		err_out << "Unrecognized characters \'" << std::string_view(begin, cur - begin) << "\'." << std::endl;
+}
+
+int JMMEScanner::yylex(JMMEParser::semantic_type *const lval, JMMEParser::location_type *location)
+{
+	using token = JMMEParser::token;
+
+	while (cur != end)
+	{
+		const char c = *cur;
+		if (is_space(c))
+		{
+			if (c == '\n')
+				line++;
+			cur++;
+			continue;
+		}
+		location->begin.line = location->end.line = line;
+
+		if (is_ident_start(c))
+		{
+			const char *const begin = cur;
+			while (++cur != end && (is_ident_start(*cur) || is_digit(*cur)));
+			lval->build<Ident>(Ident(begin, cur - begin));
+			return token::IDENT;
+		}
+
+		if (is_digit(c))
+		{
+			const char *const begin = cur;
+			int64_t val = 0;
+			for (; cur != end && is_digit(*cur); cur++)
+				if (cur - begin < 11)
+					val = val * 10 + (*cur - '0');
+			if (cur - begin > 10 || val > std::numeric_limits<int32_t>::max())
+			{
+				err_out << "Integer literal " << std::string_view(begin, cur - begin) << " out of range." << std::endl;
+				val = 0;
+			}
+			lval->build<uint32_t>(val);
+			return token::INTLIT;
+		}
+
+		// the operators; the character after the first one decides between e.g. "+", "++" and "+="
+		const char next = cur + 1 != end ? cur[1] : '\0';
+		cur++;
+		const auto assign_op = [this, lval](const ArithmeticOpType op_type)
+		{
+			cur++;
+			lval->build<ArithmeticOpType>(op_type);
+			return token::ASSIGN_OP;
+		};
+		switch (c)
+		{
+			case ';':
+				return token::SEMIC;
+			case '+':
+				if (next == '+')
+				{
+					cur++;
+					lval->build<IncdecOpType>(IncdecOpType::Increment);
+					return token::INCDEC_OP;
+				}
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Add);
+				lval->build<AdditiveOpType>(AdditiveOpType::Add);
+				return token::ADDITIVE_OP;
+			case '-':
+				if (next == '-')
+				{
+					cur++;
+					lval->build<IncdecOpType>(IncdecOpType::Decrement);
+					return token::INCDEC_OP;
+				}
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Subtract);
+				lval->build<AdditiveOpType>(AdditiveOpType::Subtract);
+				return token::ADDITIVE_OP;
+			case '*':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Multiply);
+				lval->build<MultiplicativeOpType>(MultiplicativeOpType::Multiply);
+				return token::MULTIPLICATIVE_OP;
+			case '/':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Divide);
+				lval->build<MultiplicativeOpType>(MultiplicativeOpType::Divide);
+				return token::MULTIPLICATIVE_OP;
+			case '%':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Remainder);
+				lval->build<MultiplicativeOpType>(MultiplicativeOpType::Remainder);
+				return token::MULTIPLICATIVE_OP;
+			case '&':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::And);
+				return token::AMPERSAND;
+			case '^':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Xor);
+				return token::CARET;
+			case '|':
+				if (next == '=')
+					return assign_op(ArithmeticOpType::Or);
+				return token::PIPE;
+			case '(':
+				return token::LPAREN;
+			case ')':
+				return token::RPAREN;
+			case '.':
+				return token::DOT;
+			case '=':
+				return token::ASSIGN;
+			default:
+			{
+				// a run of characters that can't start a token is reported at once
+				const char *const begin = cur - 1;
+				while (cur != end && !is_space(*cur) && !starts_token(*cur))
+					cur++;
+				report_unrecognized(begin);
+			}
+		}
+	}
+
+	// end of the input
+	location->begin.line = location->end.line = line;
+	return 0;
+}
+
+}
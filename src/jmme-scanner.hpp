@@ -1,30 +1,39 @@
 #ifndef JMME_SCANNER_HPP
 #define JMME_SCANNER_HPP
 
-#if ! defined(yyFlexLexerOnce)
-#include <FlexLexer.h>
-#endif
+#include <cstdint>
+#include <ostream>
+#include <string_view>
 
 #include "parser.hpp"
 
 namespace JMMExplorer
 {
 
-class JMMEScanner : public yyFlexLexer
+/// Splits the source code of one snippet into tokens for JMMEParser; works directly on the characters of the source code held in memory
+class JMMEScanner
 {
 public:
-	JMMEScanner(std::istream *in) : yyFlexLexer(in)
-	{
-		loc = new JMMExplorer::JMMEParser::location_type();
-	}
+	/// Constructs a scanner of text, which has to stay alive while the scanner is used; the error messages of the scanner and of the parser are written to err_out
+	JMMEScanner(std::string_view text, std::ostream& err_out);
 
-	using FlexLexer::yylex;
-
-	virtual int yylex(JMMEParser::semantic_type *const lval, JMMEParser::location_type *location);
+	/// Returns the kind of the next token, stores its semantic value into lval and its location into location; returns 0 at the end of the input
+	int yylex(JMMEParser::semantic_type *const lval, JMMEParser::location_type *location);
+	/// Returns the stream the error messages about the scanned source code are written to
+	std::ostream& get_err_out() const;
 
 private:
-	JMMEParser::semantic_type *yylval = nullptr;
-	JMMEParser::location_type *loc = nullptr;
+	// the next character to be scanned and the end of the text
+	const char *cur, *end;
+
+	// number of the line of cur
+	uint32_t line = 1;
+
+	// stream for the error messages
+	std::ostream& err_out;
+
+	// reports the unrecognized characters in [begin, cur) with a single error message
+	void report_unrecognized(const char *begin) const;
 };
 
 }
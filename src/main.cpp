@@ -1,28 +1,68 @@
 #include <cstdlib>
-#include <fstream>
+#include <iomanip>
 #include <memory>
 #include <variant>
 
 #include "analysis.hpp"
+#include "benchmarking.hpp"
+#include "source-file.hpp"
 #include "testing.hpp"
 
 namespace JMMExplorer
 {
 
+/// Prints the predicted size of the analysis in a human-readable format
+static void print_estimate(const AnalysisEstimate& estimate)
+{
+	std::cout << std::setprecision(3)
+		<< "synchronization orders: " << estimate.so_count << '\n'
+		<< "sampled orders: " << estimate.sampled_so_count << " (" << estimate.well_locked_so_count << " well locked)\n"
+		<< "write-seen candidates: " << estimate.candidate_count << '\n'
+		<< "time per candidate: " << (estimate.probe_candidate_count ? estimate.probe_seconds / estimate.probe_candidate_count * 1e6 : 0)
+		<< " us (" << estimate.probe_candidate_count << " candidates measured)\n"
+		<< "estimated time: " << estimate.seconds << " s" << std::endl;
+}
+
 /// Runs the primary application with the given command-line arguments
 static void run(const int argc, const char *const *const argv)
 {
 	bool nonexisting_file = false;
+	bool estimate_only = false;
+	AnalysisOptions options;
 	vec<std::string> filenames;
-	vec<std::unique_ptr<std::ifstream>> uq_inputs;
-	vec<std::istream*> inputs;
+	vec<std::unique_ptr<SourceFile>> files;
+	vec<std::string_view> sources;
 	for (int i = 1; i < argc; i++)
 	{
+		if (std::string_view(argv[i]) == "--sc")
+		{
+			options.sequential_consistency = true;
+			continue;
+		}
+		if (std::string_view(argv[i]) == "--estimate")
+		{
+			estimate_only = true;
+			continue;
+		}
+		if (std::string_view(argv[i]) == "--max-memory")
+		{
+			// the limit is given in MiB
+			char *end = nullptr;
+			const unsigned long long mib = i + 1 < argc ? std::strtoull(argv[i + 1], &end, 10) : 0;
+			if (!end || *end || mib == 0)
+			{
+				std::cerr << "Error: --max-memory has to be followed by a positive number of MiB." << std::endl;
+				return;
+			}
+			options.memory_limit = mib << 20;
+			i++;
+			continue;
+		}
 		filenames.push_back(argv[i]);
-		uq_inputs.push_back(std::make_unique<std::ifstream>());
-		inputs.push_back(uq_inputs.back().get());
-		uq_inputs.back()->open(argv[i]);
-		if (!*uq_inputs.back())
+		files.push_back(std::make_unique<SourceFile>());
+		const bool opened = files.back()->open(argv[i]);
+		sources.push_back(files.back()->get_text());
+		if (!opened)
 		{
 			std::cerr << "Error: Source file " << argv[i] << " doesn't exist." << std::endl;
 			nonexisting_file = true;
@@ -34,24 +74,37 @@ static void run(const int argc, const char *const *const argv)
 		std::cout << "Terminating due to a non-existing source file." << std::endl;
 		return;
 	}
-	vec<ExecutionResult> results;
-	if (analyze(filenames, inputs, results, std::cerr))
+	Program program;
+	if (program.parse(filenames, sources, std::cerr))
 		return;
-	for (const ExecutionResult& res : results)
+	if (estimate_only)
 	{
-		res.print(std::cout, [&filenames](const uint32_t threadi){ return filenames[threadi]; });
-		std::cout << '\n';
+		print_estimate(program.estimate());
+		return;
 	}
+	// the results are printed as soon as they are found
+	const AnalysisStatus status = program.analyze([&program](const ExecutionResult& res)
+	{
+		res.print(std::cout, [&program](const uint32_t threadi){ return program.get_thread_name(threadi); });
+		std::cout << '\n';
+		return true;
+	}, options);
+	if (status == AnalysisStatus::MemoryExhausted)
+		std::cerr << "Warning: The analysis has reached the memory limit of " << (options.memory_limit >> 20)
+			<< " MiB and has been stopped, so only a part of the possible outputs has been printed." << std::endl;
 }
 
 }
 
 int main(const int argc, const char *const *const argv)
 {
-#ifndef TESTING
-	JMMExplorer::run(argc, argv);
-#else
+#if defined(TESTING)
 	JMMExplorer::run_all_tests();
+#elif defined(BENCHMARKING)
+	// the optional argument is the number of statements in every thread of the synthetic program
+	JMMExplorer::run_all_benchmarks(argc > 1 ? std::atoi(argv[1]) : 8);
+#else
+	JMMExplorer::run(argc, argv);
 #endif
 	return EXIT_SUCCESS;
 }
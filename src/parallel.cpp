@@ -0,0 +1,32 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+void parallel_for(const uint32_t count, const std::function<void(uint32_t)>& body)
+{
+	const uint32_t thread_count = std::min(count, std::max(1u, std::thread::hardware_concurrency()));
+
+	// the next index that hasn't been taken by any thread yet
+	std::atomic<uint32_t> next(0);
+	const auto work = [&]()
+	{
+		for (uint32_t i = next++; i < count; i = next++)
+			body(i);
+	};
+
+	vec<std::thread> workers;
+	for (uint32_t i = 1; i < thread_count; i++)
+		workers.emplace_back(work);
+	work();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+}
@@ -0,0 +1,15 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstdint>
+#include <functional>
+
+namespace JMMExplorer
+{
+
+/// Calls body(i) for every i < count, spread over as many threads as the hardware runs at once (the calls for different indices have to be independent of each other)
+void parallel_for(uint32_t count, const std::function<void(uint32_t)>& body);
+
+}
+
+#endif // PARALLEL_HPP
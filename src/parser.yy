@@ -139,5 +139,5 @@ primary_expression:
 
 void JMMExplorer::JMMEParser::error(const location_type& loc, const std::string& msg)
 {
-	std::cerr << "Parser error: " << msg << " at " << loc << '\n';
+	scanner.get_err_out() << "Parser error: " << msg << " at " << loc << '\n';
 }
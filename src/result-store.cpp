@@ -0,0 +1,210 @@
+#include "result-store.hpp"
+
+#include <algorithm>
+#include <queue>
+
+namespace JMMExplorer
+{
+
+/// Maximal number of runs in temporary files; when there would be more, all of them but the first one are merged into one
+static constexpr uint32_t max_run_count = 16;
+
+/// Reads the next key of width values from run into key; returns false at the end of the run
+static bool read_key(FILE *const run, vec<int32_t>& key)
+{
+	return std::fread(key.data(), sizeof(int32_t), key.size(), run) == key.size();
+}
+
+/// Writes the key of width values starting at key to run
+static void write_key(FILE *const run, const int32_t *const key, const uint32_t width)
+{
+	std::fwrite(key, sizeof(int32_t), width, run);
+}
+
+ResultStore::ResultStore(const vec<uint32_t>& print_counts, const uint64_t memory_limit)
+	: offsets(1, 0), keys(print_counts.size()), memory_limit(memory_limit), key(print_counts.size())
+{
+	for (const uint32_t print_count : print_counts)
+	{
+		outputs.emplace_back(print_count);
+		offsets.push_back(offsets.back() + print_count);
+	}
+}
+
+ResultStore::~ResultStore()
+{
+	for (FILE *const run : runs)
+		std::fclose(run);
+}
+
+bool ResultStore::add(const ExecutionResult& res)
+{
+	if (std::holds_alternative<ExceptedExecutionResult>(res.result))
+	{
+		const ExceptedExecutionResult& eres = std::get<ExceptedExecutionResult>(res.result);
+		if (std::find(exceptions.begin(), exceptions.end(), eres) != exceptions.end())
+			return false;
+		exceptions.push_back(eres);
+		return true;
+	}
+	flat.clear();
+	for (const vec<int32_t>& thread_output : std::get<RegularExecutionResult>(res.result))
+		flat.insert(flat.end(), thread_output.begin(), thread_output.end());
+	return add_flat(flat.data());
+}
+
+bool ResultStore::add_flat(const int32_t *const output)
+{
+	bool inserted;
+	for (uint32_t i = 0; i < outputs.size(); i++)
+		key[i] = outputs[i].intern(output + offsets[i], inserted);
+	keys.intern(key.data(), inserted);
+	if (!inserted)
+		return false;
+	const bool reported = runs.empty();
+	// with no threads, there is only one possible result, so there is nothing to spill
+	if (memory_limit && memory_use() > memory_limit && !outputs.empty())
+		spill();
+	return reported;
+}
+
+RegularExecutionResult ResultStore::unflatten(const int32_t *const output) const
+{
+	RegularExecutionResult res(outputs.size());
+	for (uint32_t i = 0; i < outputs.size(); i++)
+		res[i].assign(output + offsets[i], output + offsets[i + 1]);
+	return res;
+}
+
+bool ResultStore::flush(const ResultSink& sink)
+{
+	// without any run, all the results have been reported by add
+	if (runs.empty())
+		return true;
+	return merge(0, true, [this, &sink](const int32_t *const k, const bool reported){ return reported || sink(decode(k)); });
+}
+
+bool ResultStore::for_each(const ResultSink& sink)
+{
+	if (!merge(0, true, [this, &sink](const int32_t *const k, bool){ return sink(decode(k)); }))
+		return false;
+	for (const ExceptedExecutionResult& eres : exceptions)
+		if (!sink({ eres }))
+			return false;
+	return true;
+}
+
+uint32_t ResultStore::get_spilled_run_count() const
+{
+	return runs.size();
+}
+
+uint64_t ResultStore::get_memory_limit() const
+{
+	return memory_limit;
+}
+
+uint64_t ResultStore::memory_use() const
+{
+	uint64_t use = keys.memory_use();
+	for (const FlatInterner& thread_outputs : outputs)
+		use += thread_outputs.memory_use();
+	return use;
+}
+
+void ResultStore::spill()
+{
+	FILE *run = std::tmpfile();
+	// without a temporary file, the results just stay in memory
+	if (!run)
+		return;
+
+	const uint32_t width = outputs.size();
+	for (const uint32_t id : sorted_key_ids())
+		write_key(run, keys.get(id), width);
+	runs.push_back(run);
+	keys.clear();
+
+	if (runs.size() < max_run_count)
+		return;
+	run = std::tmpfile();
+	if (!run)
+		return;
+	merge(1, false, [run, width](const int32_t *const k, bool){ write_key(run, k, width); return true; });
+	for (uint32_t i = 1; i < runs.size(); i++)
+		std::fclose(runs[i]);
+	runs.resize(1);
+	runs.push_back(run);
+}
+
+vec<uint32_t> ResultStore::sorted_key_ids() const
+{
+	const uint32_t width = outputs.size();
+	vec<uint32_t> ids(keys.size());
+	for (uint32_t id = 0; id < ids.size(); id++)
+		ids[id] = id;
+	std::sort(ids.begin(), ids.end(), [this, width](const uint32_t a, const uint32_t b)
+		{ return std::lexicographical_compare(keys.get(a), keys.get(a) + width, keys.get(b), keys.get(b) + width); });
+	return ids;
+}
+
+ExecutionResult ResultStore::decode(const int32_t *const k) const
+{
+	RegularExecutionResult res(outputs.size());
+	for (uint32_t i = 0; i < outputs.size(); i++)
+	{
+		const int32_t *const thread_output = outputs[i].get(k[i]);
+		res[i].assign(thread_output, thread_output + (offsets[i + 1] - offsets[i]));
+	}
+	return { res };
+}
+
+bool ResultStore::merge(const uint32_t first, const bool with_memory, const std::function<bool(const int32_t*, bool)>& visit)
+{
+	const uint32_t width = outputs.size();
+
+	// the keys in memory form one more sorted run (the last one)
+	const vec<uint32_t> memory_order = with_memory ? sorted_key_ids() : vec<uint32_t>();
+
+	// the current key of every run and a min-heap of the runs by their current keys
+	const uint32_t run_count = runs.size() - first + with_memory;
+	vec<vec<int32_t>> current(run_count, vec<int32_t>(width));
+	size_t memory_pos = 0;
+	const auto advance = [&](const uint32_t runi)
+	{
+		if (first + runi < runs.size())
+			return read_key(runs[first + runi], current[runi]);
+		if (memory_pos == memory_order.size())
+			return false;
+		const int32_t *const k = keys.get(memory_order[memory_pos++]);
+		std::copy_n(k, width, current[runi].begin());
+		return true;
+	};
+	const auto greater = [&current](const uint32_t a, const uint32_t b){ return current[a] > current[b]; };
+	std::priority_queue<uint32_t, vec<uint32_t>, decltype(greater)> heap(greater);
+	for (uint32_t i = first; i < runs.size(); i++)
+		std::rewind(runs[i]);
+	for (uint32_t runi = 0; runi < run_count; runi++)
+		if (advance(runi))
+			heap.push(runi);
+
+	vec<int32_t> smallest(width);
+	while (!heap.empty())
+	{
+		smallest = current[heap.top()];
+		bool reported = false;
+		while (!heap.empty() && current[heap.top()] == smallest)
+		{
+			const uint32_t runi = heap.top();
+			heap.pop();
+			reported |= first == 0 && runi == 0 && !runs.empty();
+			if (advance(runi))
+				heap.push(runi);
+		}
+		if (!visit(smallest.data(), reported))
+			return false;
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef RESULT_STORE_HPP
+#define RESULT_STORE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+
+#include "analysis.hpp"
+#include "flat-interner.hpp"
+#include "vec.hpp"
+
+namespace JMMExplorer
+{
+
+/// Set of the distinct execution results found by an analysis whose memory use is bounded
+/// A regular result is given in the flat form: the values printed by all the threads one thread after another, each thread printing a fixed number of values
+/// The output of every thread is interned to a small id and a result is kept as the fixed-width key of the ids of its threads' outputs; the keys are kept
+/// in a hash table until the memory use grows over the limit, then they are written to a temporary file as a sorted run and the table is cleared,
+/// and the runs are merged (dropping the duplicates) once the analysis has finished
+/// As long as nothing has been written to a file, every new result is recognized as new immediately; after that, the results that weren't reported
+/// as new right away are only reported by flush (the exceptions, of which there are only few, are always kept in memory)
+class ResultStore
+{
+public:
+	/// Constructs an empty store of the results of threads printing print_counts[i] values in thread i that keeps at most about memory_limit bytes
+	/// of results in memory (0 means no limit)
+	ResultStore(const vec<uint32_t>& print_counts, uint64_t memory_limit);
+	~ResultStore();
+
+	ResultStore(const ResultStore&) = delete;
+	ResultStore& operator=(const ResultStore&) = delete;
+
+	/// Adds res to the store; returns true iff res is new and has to be reported right now
+	bool add(const ExecutionResult& res);
+	/// Adds the regular execution result given in the flat form by output (like add, but without constructing an ExecutionResult)
+	bool add_flat(const int32_t* output);
+	/// Converts the regular execution result given in the flat form by output into a RegularExecutionResult
+	RegularExecutionResult unflatten(const int32_t* output) const;
+	/// Passes every distinct result that add hasn't reported yet to sink (in the order of their keys); returns false iff the sink has cancelled it
+	bool flush(const ResultSink& sink);
+	/// Passes every distinct result in the store to sink (the regular ones in the order of their keys, then the exceptions); returns false iff the sink has cancelled it
+	bool for_each(const ResultSink& sink);
+	/// Returns the number of sorted runs written to temporary files so far
+	uint32_t get_spilled_run_count() const;
+	/// Returns the limit of the memory used by the results given to the constructor
+	uint64_t get_memory_limit() const;
+	/// Returns the number of bytes of memory used by the results kept in memory
+	uint64_t memory_use() const;
+
+private:
+	// for each thread, the index of its first value in the flat form (with the total number of values at the end)
+	vec<uint32_t> offsets;
+
+	// for each thread, the ids of its distinct outputs
+	vec<FlatInterner> outputs;
+
+	// the keys (the ids of the outputs of all the threads) of the regular results kept in memory
+	FlatInterner keys;
+
+	// the distinct excepted results
+	vec<ExceptedExecutionResult> exceptions;
+
+	// limit of the memory used by the results in bytes
+	uint64_t memory_limit;
+
+	// temporary files with the sorted runs of keys; the first one holds the results already reported by add
+	vec<FILE*> runs;
+
+	// buffers for building a key and for flattening a result (kept to reuse their memory)
+	vec<int32_t> key, flat;
+
+	// writes the keys in memory into a new run and clears them (merging all the runs but the first one into one when there are too many of them)
+	void spill();
+
+	// returns the ids of the keys in memory in the order of the keys
+	vec<uint32_t> sorted_key_ids() const;
+
+	// converts a key into the regular execution result
+	ExecutionResult decode(const int32_t* key) const;
+
+	// calls visit(key, reported) for every distinct key in the runs starting with the run with index first (and in memory if with_memory is true) in sorted order,
+	// where reported is true iff the key is in the first run and first is 0; stops and returns false as soon as visit returns false
+	bool merge(uint32_t first, bool with_memory, const std::function<bool(const int32_t*, bool)>& visit);
+};
+
+}
+
+#endif // RESULT_STORE_HPP
@@ -1,9 +1,12 @@
 #include "snippet.hpp"
 #include "jmme-language.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
-#include <stack>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <variant>
 
 namespace JMMExplorer
@@ -118,46 +121,119 @@ LocalValue Snippet::emit_arithmetic(const LocalValue op0, const LocalValue op1,
 
 void Snippet::print(std::ostream& os) const
 {
-	const auto val_to_str = [this](const LocalValue val)
+	print_instructions(os, [this](const size_t local_id){ return locals[local_id]; }, [](const Ident& name){ return name; }, [](const Instruction&){ return str(); });
+}
+
+void Snippet::print_canonical(std::ostream& os, const std::function<Ident(const Ident&)>& rename_global, vec<uint32_t>& line_map) const
+{
+	// canonical index of each local variable in the order of first use (or -1 if not yet used)
+	vec<int32_t> local_order(locals.size(), -1);
+	int32_t next_local = 0;
+	const auto use_local = [&](const size_t local_id)
 	{
-		return val.is_literal() ? std::to_string(val.get_literal()) : locals[val.get_local_id()];
+		if (local_order[local_id] == -1)
+			local_order[local_id] = next_local++;
+	};
+	const auto use_value = [&](const LocalValue& val)
+	{
+		if (!val.is_literal())
+			use_local(val.get_local_id());
+	};
+	for (const Instruction& instr : instructions)
+	{
+		if (instr.is_arithmetic())
+		{
+			use_value(instr.as_arithmetic().op0);
+			use_value(instr.as_arithmetic().op1);
+			use_local(instr.as_arithmetic().target);
+		}
+		else if (instr.is_read())
+			use_local(instr.get_read_target());
+		else if (instr.is_write())
+			use_value(instr.get_write_data());
+		else if (instr.is_move())
+		{
+			use_value(instr.as_move().data);
+			use_local(instr.as_move().local_id);
+		}
+		else if (instr.is_print())
+			use_value(instr.get_print_arg());
+	}
+
+	line_map.clear();
+	print_instructions(os, [&local_order](const size_t local_id){ return "l" + std::to_string(local_order[local_id]); }, rename_global, [&line_map](const Instruction& instr)
+	{
+		if (!instr.is_arithmetic())
+			return str();
+		const ArithmeticInstruction& ari = instr.as_arithmetic();
+		if ((ari.op_type != ArithmeticOpType::Divide && ari.op_type != ArithmeticOpType::Remainder) || (ari.op1.is_literal() && ari.op1.get_literal() != 0))
+			return str();
+		const uint32_t line = instr.location.begin.line;
+		const auto it = std::find(line_map.begin(), line_map.end(), line);
+		const size_t renumbered = it - line_map.begin() + 1;
+		if (it == line_map.end())
+			line_map.push_back(line);
+		return "@" + std::to_string(renumbered) + " ";
+	});
+}
+
+vec<Ident> Snippet::get_global_names() const
+{
+	vec<Ident> res;
+	for (const uint32_t acti : actions)
+	{
+		const Instruction& action = instructions[acti];
+		const Ident name = action.is_lock() || action.is_unlock() ? action.get_monitor_name()
+			: action.is_volatile_read() || action.is_volatile_write() ? action.get_volatile_name() : action.get_shared_name();
+		if (std::find(res.begin(), res.end(), name) == res.end())
+			res.push_back(name);
+	}
+	return res;
+}
+
+void Snippet::print_instructions(std::ostream& os, const std::function<str(size_t)>& local_name, const std::function<Ident(const Ident&)>& global_name, const std::function<str(const Instruction&)>& line_prefix) const
+{
+	const auto val_to_str = [&local_name](const LocalValue val)
+	{
+		return val.is_literal() ? std::to_string(val.get_literal()) : local_name(val.get_local_id());
 	};
 	for (const Instruction& instr : instructions)
 	{
 		const auto& vari = instr.instr;
+		os << line_prefix(instr);
 		if (std::holds_alternative<LockInstruction>(vari))
-			os << "lock " << std::get<LockInstruction>(vari).monitor_name << '\n';
+			os << "lock " << global_name(std::get<LockInstruction>(vari).monitor_name) << '\n';
 		else if (std::holds_alternative<UnlockInstruction>(vari))
-			os << "unlock " << std::get<UnlockInstruction>(vari).monitor_name << '\n';
+			os << "unlock " << global_name(std::get<UnlockInstruction>(vari).monitor_name) << '\n';
 		else if (std::holds_alternative<ArithmeticInstruction>(vari))
 		{
 			const auto& ari = std::get<ArithmeticInstruction>(vari);
-			os << get_mnemonic(ari.op_type) << " " << locals[ari.target] << ", " << val_to_str(ari.op0) << ", " << val_to_str(ari.op1) << '\n';
+			os << get_mnemonic(ari.op_type) << " " << local_name(ari.target) << ", " << val_to_str(ari.op0) << ", " << val_to_str(ari.op1) << '\n';
 		}
 		else if (std::holds_alternative<SharedReadInstruction>(vari))
 		{
 			const auto& sre = std::get<SharedReadInstruction>(vari);
-			os << "sre " << locals[sre.target] << ", " << sre.shared_source << '\n';
+			os << "sre " << local_name(sre.target) << ", " << global_name(sre.shared_source) << '\n';
 		}
 		else if (std::holds_alternative<SharedWriteInstruction>(vari))
 		{
 			const auto& swr = std::get<SharedWriteInstruction>(vari);
-			os << "swr " << val_to_str(swr.data) << ", " << swr.shared_target << '\n';
+			os << "swr " << val_to_str(swr.data) << ", " << global_name(swr.shared_target) << '\n';
 		}
 		else if (std::holds_alternative<VolatileReadInstruction>(vari))
 		{
 			const auto& vre = std::get<VolatileReadInstruction>(vari);
-			os << "vre " << locals[vre.target] << ", " << vre.volatile_source << '\n';
+			os << "vre " << local_name(vre.target) << ", " << global_name(vre.volatile_source) << '\n';
 		}
 		else if (std::holds_alternative<VolatileWriteInstruction>(vari))
 		{
 			const auto& vwr = std::get<VolatileWriteInstruction>(vari);
-			os << "vwr " << val_to_str(vwr.data) << ", " << vwr.volatile_target << '\n';
+			os << "vwr " << val_to_str(vwr.data) << ", " << global_name(vwr.volatile_target) << '\n';
 		}
 		else if (std::holds_alternative<MoveInstruction>(vari))
 		{
 			const auto& mov = std::get<MoveInstruction>(vari);
-			os << "mov " << locals[mov.local_id] << ", " << val_to_str(mov.data) << '\n';
+			os << "mov " << local_name(mov.local_id) << ", " << val_to_str(mov.data) << '\n';
 		}
 		else if (std::holds_alternative<PrintInstruction>(vari))
 		{
@@ -300,6 +376,26 @@ vec<uint32_t> Snippet::get_synchronization_actions() const
 	return res;
 }
 
+const uint32_t* ReadSetView::begin() const
+{
+	return first;
+}
+
+const uint32_t* ReadSetView::end() const
+{
+	return last;
+}
+
+uint32_t ReadSetView::size() const
+{
+	return last - first;
+}
+
+bool ReadSetView::empty() const
+{
+	return first == last;
+}
+
 Snippet::Snippet(const str& name)
 	: name(name)
 {
@@ -310,18 +406,217 @@ const str& Snippet::get_name() const
 	return name;
 }
 
+void Snippet::optimize()
+{
+	// for each local variable, the value it currently holds -- either a literal or a local variable which is written exactly once (an arithmetic or a read target)
+	vec<LocalValue> local_value(locals.size(), LocalValue::from_literal(0));
+
+	// for each local variable, true iff computing its current value can cause a division by zero exception
+	vec<bool> may_throw(locals.size(), false);
+
+	// maps an arithmetic operation on particular values to the local variable already holding its result
+	std::map<std::tuple<ArithmeticOpType, bool, size_t, bool, size_t>, size_t> computed;
+
+	const auto resolve = [&local_value](const LocalValue val)
+	{
+		return val.is_literal() ? val : local_value[val.get_local_id()];
+	};
+	const auto throws = [&may_throw](const LocalValue val)
+	{
+		return !val.is_literal() && may_throw[val.get_local_id()];
+	};
+	const auto is_literal_of = [](const LocalValue val, const int32_t literal)
+	{
+		return val.is_literal() && static_cast<int32_t>(val.get_literal()) == literal;
+	};
+
+	vec<Instruction> optimized;
+	for (const Instruction& instr : instructions)
+	{
+		auto& vari = instr.instr;
+		if (std::holds_alternative<ArithmeticInstruction>(vari))
+		{
+			const ArithmeticInstruction& ari = std::get<ArithmeticInstruction>(vari);
+			const LocalValue op0 = resolve(ari.op0), op1 = resolve(ari.op1);
+			const ArithmeticOpType op_type = ari.op_type;
+			const bool divides = op_type == ArithmeticOpType::Divide || op_type == ArithmeticOpType::Remainder;
+			const bool commutative = op_type == ArithmeticOpType::Add || op_type == ArithmeticOpType::Multiply || op_type == ArithmeticOpType::Or
+				|| op_type == ArithmeticOpType::Xor || op_type == ArithmeticOpType::And;
+			int32_t folded;
+			if (op0.is_literal() && op1.is_literal() && apply_arithmetic(op_type, op0.get_literal(), op1.get_literal(), folded))
+			{
+				local_value[ari.target] = LocalValue::from_literal(folded);
+				continue;
+			}
+
+			// identities that make the operation a copy of one of its operands
+			if ((is_literal_of(op1, 0) && (op_type == ArithmeticOpType::Add || op_type == ArithmeticOpType::Subtract || op_type == ArithmeticOpType::Or || op_type == ArithmeticOpType::Xor))
+				|| (is_literal_of(op1, 1) && (op_type == ArithmeticOpType::Multiply || op_type == ArithmeticOpType::Divide))
+				|| (is_literal_of(op1, -1) && op_type == ArithmeticOpType::And))
+			{
+				local_value[ari.target] = op0;
+				may_throw[ari.target] = throws(op0);
+				continue;
+			}
+			if (commutative && ((is_literal_of(op0, 0) && op_type != ArithmeticOpType::Multiply && op_type != ArithmeticOpType::And)
+				|| (is_literal_of(op0, 1) && op_type == ArithmeticOpType::Multiply) || (is_literal_of(op0, -1) && op_type == ArithmeticOpType::And)))
+			{
+				local_value[ari.target] = op1;
+				may_throw[ari.target] = throws(op1);
+				continue;
+			}
+
+			// identities that make the result zero (only if the dropped operand doesn't have to be computed for its exception)
+			if (((is_literal_of(op1, 0) || is_literal_of(op0, 0)) && (op_type == ArithmeticOpType::Multiply || op_type == ArithmeticOpType::And) && !throws(op0) && !throws(op1))
+				|| ((is_literal_of(op1, 1) || is_literal_of(op1, -1)) && op_type == ArithmeticOpType::Remainder && !throws(op0)))
+			{
+				local_value[ari.target] = LocalValue::from_literal(0);
+				continue;
+			}
+
+			const bool can_throw = divides && !(op1.is_literal() && op1.get_literal() != 0);
+			if (!can_throw)
+			{
+				// common subexpression elimination (an operation that can throw isn't merged, so that the exception is reported at the right line)
+				auto key0 = std::make_tuple(op0.is_literal(), op0.is_literal() ? op0.get_literal() : op0.get_local_id());
+				auto key1 = std::make_tuple(op1.is_literal(), op1.is_literal() ? op1.get_literal() : op1.get_local_id());
+				if (commutative && key1 < key0)
+					std::swap(key0, key1);
+				const auto key = std::make_tuple(op_type, std::get<0>(key0), std::get<1>(key0), std::get<0>(key1), std::get<1>(key1));
+				const auto it = computed.find(key);
+				if (it != computed.end())
+				{
+					local_value[ari.target] = LocalValue::from_local(it->second);
+					continue;
+				}
+				computed[key] = ari.target;
+			}
+			optimized.push_back({ ArithmeticInstruction{ ari.target, op0, op_type, op1 }, instr.location });
+			local_value[ari.target] = LocalValue::from_local(ari.target);
+			may_throw[ari.target] = can_throw || throws(op0) || throws(op1);
+		}
+		else if (std::holds_alternative<MoveInstruction>(vari))
+		{
+			const MoveInstruction& mov = std::get<MoveInstruction>(vari);
+			const LocalValue data = resolve(mov.data);
+			local_value[mov.local_id] = data;
+			may_throw[mov.local_id] = throws(data);
+		}
+		else if (std::holds_alternative<SharedReadInstruction>(vari) || std::holds_alternative<VolatileReadInstruction>(vari))
+		{
+			optimized.push_back(instr);
+			local_value[instr.get_read_target()] = LocalValue::from_local(instr.get_read_target());
+			may_throw[instr.get_read_target()] = false;
+		}
+		else if (std::holds_alternative<SharedWriteInstruction>(vari))
+		{
+			const SharedWriteInstruction& swr = std::get<SharedWriteInstruction>(vari);
+			optimized.push_back({ SharedWriteInstruction{ swr.shared_target, resolve(swr.data) }, instr.location });
+		}
+		else if (std::holds_alternative<VolatileWriteInstruction>(vari))
+		{
+			const VolatileWriteInstruction& vwr = std::get<VolatileWriteInstruction>(vari);
+			optimized.push_back({ VolatileWriteInstruction{ vwr.volatile_target, resolve(vwr.data) }, instr.location });
+		}
+		else if (std::holds_alternative<PrintInstruction>(vari))
+			optimized.push_back({ PrintInstruction{ resolve(std::get<PrintInstruction>(vari).arg) }, instr.location });
+		else
+			optimized.push_back(instr);
+	}
+
+	// dead code elimination: going backwards, keep only the arithmetic instructions whose result is used by an instruction that is kept
+	vec<bool> used(locals.size(), false);
+	const auto use = [&used](const LocalValue val)
+	{
+		if (!val.is_literal())
+			used[val.get_local_id()] = true;
+	};
+	vec<bool> keep(optimized.size(), true);
+	for (uint32_t i = optimized.size(); i-- > 0;)
+	{
+		const Instruction& instr = optimized[i];
+		if (instr.is_arithmetic())
+		{
+			keep[i] = used[instr.as_arithmetic().target];
+			if (keep[i])
+			{
+				use(instr.as_arithmetic().op0);
+				use(instr.as_arithmetic().op1);
+			}
+		}
+		else if (instr.is_write())
+			use(instr.get_write_data());
+		else if (instr.is_print())
+			use(instr.get_print_arg());
+	}
+
+	instructions.clear();
+	actions.clear();
+	for (uint32_t i = 0; i < optimized.size(); i++)
+		if (keep[i])
+		{
+			instructions.push_back(optimized[i]);
+			if (instructions.back().is_action())
+				pushed_action();
+		}
+}
+
 void Snippet::run_preexecution_analysis()
 {
+	// initialize the sets of reads (with the empty set) and the index of the distinct ones by their hashes
+	read_set_data.clear();
+	read_set_offsets.assign(2, 0);
+	std::unordered_multimap<size_t, uint32_t> read_set_ids;
+	const auto hash_set = [](const uint32_t *const first, const uint32_t *const last)
+	{
+		size_t hash = last - first;
+		for (const uint32_t *it = first; it != last; it++)
+			hash = hash * 1000003 ^ *it;
+		return hash;
+	};
+
+	// returns the id of the set of reads with the elements in set, adding it if it is new
+	const auto intern_read_set = [this, &read_set_ids, &hash_set](const vec<uint32_t>& set)
+	{
+		const size_t hash = hash_set(set.data(), set.data() + set.size());
+		const auto range = read_set_ids.equal_range(hash);
+		for (auto it = range.first; it != range.second; it++)
+		{
+			const ReadSetView existing = get_read_set(it->second);
+			if (std::equal(existing.begin(), existing.end(), set.begin(), set.end()))
+				return it->second;
+		}
+		const uint32_t id = read_set_offsets.size() - 1;
+		read_set_data.insert(read_set_data.end(), set.begin(), set.end());
+		read_set_offsets.push_back(read_set_data.size());
+		read_set_ids.emplace(hash, id);
+		return id;
+	};
+
+	// returns the id of the union of the sets of reads with ids id0 and id1 (merge is a scratch buffer)
+	vec<uint32_t> merge;
+	const auto unite_read_sets = [this, &intern_read_set, &merge](const uint32_t id0, const uint32_t id1)
+	{
+		if (id0 == id1 || id1 == 0)
+			return id0;
+		if (id0 == 0)
+			return id1;
+		const ReadSetView set0 = get_read_set(id0), set1 = get_read_set(id1);
+		merge.clear();
+		std::set_union(set0.begin(), set0.end(), set1.begin(), set1.end(), std::back_inserter(merge));
+		return intern_read_set(merge);
+	};
+
 	// initialize argument_deps and trans_read_deps
 	argument_deps = vec<vec<int32_t>>(instructions.size());
-	trans_read_deps = vec<vec<uint32_t>>(instructions.size());
+	trans_read_deps = vec<uint32_t>(instructions.size(), 0);
 	uint32_t nact = 0;
 	for (uint32_t i = 0; i < instructions.size(); i++)
 	{
 		if (nact < actions.size() && actions[nact] < i)
 			nact++;
 		if (instructions[i].is_read())
-			trans_read_deps[i].push_back(nact);
+			trans_read_deps[i] = intern_read_set({ nact });
 	}
 
 	// for each local variable, the index of the instruction that last wrote to it or -1 if none has yet
@@ -342,37 +637,8 @@ void Snippet::run_preexecution_analysis()
 			if (!ari.op1.is_literal())
 			{
 				argument_deps[i].push_back(local_written_at[ari.op1.get_local_id()]);
-
 				if (argument_deps[i].back() != -1)
-				{
-					// merge of two sorted arrays (the transitive read dependencies of the first and of the second operand)
-					
-					vec<uint32_t> nwtransdp;
-					uint32_t p0 = 0, p1 = 0;
-					vec<uint32_t> &d0 = trans_read_deps[i], &d1 = trans_read_deps[argument_deps[i].back()];
-					while (true)
-					{
-						if (p0 != d0.size() && p1 != d1.size())
-						{
-							if (d0[p0] == d1[p1])
-							{
-								nwtransdp.push_back(d0[p0++]);
-								p1++;
-							}
-							else if (d0[p0] < d1[p1])
-								nwtransdp.push_back(d0[p0++]);
-							else
-								nwtransdp.push_back(d1[p1++]);
-						}
-						else if (p0 != d0.size())
-							nwtransdp.push_back(d0[p0++]);
-						else if (p1 != d1.size())
-							nwtransdp.push_back(d1[p1++]);
-						else
-							break;
-					}
-					swap(trans_read_deps[i], nwtransdp);
-				}
+					trans_read_deps[i] = unite_read_sets(trans_read_deps[i], trans_read_deps[argument_deps[i].back()]);
 			}
 			local_written_at[ari.target] = i;
 		}
@@ -401,8 +667,31 @@ void Snippet::run_preexecution_analysis()
 			local_written_at[instr.get_read_target()] = i;
 	}
 
-	// initialized instr_evaluated and instr_value
-	instr_evaluated = vec<bool>(instructions.size());
+	// initialize trans_may_throw
+	trans_may_throw = vec<bool>(instructions.size());
+	for (uint32_t i = 0; i < instructions.size(); i++)
+	{
+		const Instruction& instr = instructions[i];
+		if (instr.is_arithmetic())
+		{
+			const ArithmeticInstruction& ari = instr.as_arithmetic();
+			trans_may_throw[i] = (ari.op_type == ArithmeticOpType::Divide || ari.op_type == ArithmeticOpType::Remainder) && !(ari.op1.is_literal() && ari.op1.get_literal() != 0);
+		}
+		for (const int32_t dep : argument_deps[i])
+			if (dep != -1 && trans_may_throw[dep])
+				trans_may_throw[i] = true;
+	}
+
+	// initialize read_dependents
+	read_dependents = vec<vec<uint32_t>>(actions.size());
+	for (uint32_t i = 0; i < instructions.size(); i++)
+		for (const uint32_t read : get_read_set(trans_read_deps[i]))
+			if (actions[read] != i)
+				read_dependents[read].push_back(i);
+
+	// initialize instr_evaluated_in and instr_value
+	instr_evaluated_in = vec<uint32_t>(instructions.size(), 0);
+	execution_number = 0;
 	instr_value = vec<int32_t>(instructions.size());
 }
 
@@ -416,40 +705,12 @@ void Snippet::exec_eval(const uint32_t instri)
 		const int32_t v0 = ari.op0.is_literal() ? ari.op0.get_literal() : (nex++, argument_deps[instri][0] != -1 ? instr_value[argument_deps[instri][0]] : 0);
 		const int32_t v1 = ari.op1.is_literal() ? ari.op1.get_literal() : argument_deps[instri][nex] != -1 ? instr_value[argument_deps[instri][nex]] : 0;
 		int32_t res;
-		if (ari.op_type == ArithmeticOpType::Add)
-			res = static_cast<uint32_t>(v0) + static_cast<uint32_t>(v1);
-		else if (ari.op_type == ArithmeticOpType::Subtract)
-			res = static_cast<uint32_t>(v0) - static_cast<uint32_t>(v1);
-		else if (ari.op_type == ArithmeticOpType::Multiply)
-			res = static_cast<uint32_t>(v0) * static_cast<uint32_t>(v1);
-		else if (ari.op_type == ArithmeticOpType::Divide)
+		if (!apply_arithmetic(ari.op_type, v0, v1, res))
 		{
-			if (v1 == 0)
-			{
-				zerodiv_excepted = true;
-				excepted_at_line = instr.location.begin.line;
-				return;
-			}
-			res = static_cast<int64_t>(v0) / v1;
-		}
-		else if (ari.op_type == ArithmeticOpType::Remainder)
-		{
-			if (v1 == 0)
-			{
-				zerodiv_excepted = true;
-				excepted_at_line = instr.location.begin.line;
-				return;
-			}
-			res = static_cast<int64_t>(v0) % v1;
+			zerodiv_excepted = true;
+			excepted_at_line = instr.location.begin.line;
+			return;
 		}
-		else if (ari.op_type == ArithmeticOpType::Or)
-			res = v0 | v1;
-		else if (ari.op_type == ArithmeticOpType::Xor)
-			res = v0 ^ v1;
-		else if (ari.op_type == ArithmeticOpType::And)
-			res = v0 & v1;
-		else
-			assert(false);
 		instr_value[instri] = res;
 	}
 	else if (instr.is_write() || instr.is_move() || instr.is_print())
@@ -464,55 +725,60 @@ void Snippet::exec_eval(const uint32_t instri)
 		}();
 		instr_value[instri] = data.is_literal() ? data.get_literal() : argument_deps[instri][0] != -1 ? instr_value[argument_deps[instri][0]] : 0;
 	}
-	instr_evaluated[instri] = true;
+	instr_evaluated_in[instri] = execution_number;
 }
 
 void Snippet::request_eval(const uint32_t instri)
 {
-	if (instr_evaluated[instri])
+	if (instr_evaluated_in[instri] == execution_number)
 		return;
 
-	// stack of instruction to go through: in each pair
-	// -- the first element is the instruction index
-	// -- the second element is the next index in the instruction's argument dependencies that should be visited
-	std::stack<std::pair<uint32_t, uint32_t>> st;
-
-	st.push({ instri, 0 });
-	while (!st.empty())
+	eval_stack.clear();
+	eval_stack.push_back({ instri, 0 });
+	while (!eval_stack.empty())
 	{
-		auto& cur = st.top();
+		auto& cur = eval_stack.back();
 		if (cur.second == argument_deps[cur.first].size())
 		{
 			// all argument dependencies have been visited and resolved, we can evaluate the instruction currently at the top of the stack
 
 			exec_eval(cur.first);
-			st.pop();
+			eval_stack.pop_back();
 		}
 		else
 		{
 			const int32_t dep = argument_deps[cur.first][cur.second++];
-			if (dep != -1 && !instr_evaluated[dep])
-				st.push({ dep, 0 });
+			if (dep != -1 && instr_evaluated_in[dep] != execution_number)
+				eval_stack.push_back({ static_cast<uint32_t>(dep), 0 });
 		}
 	}
 }
 
 void Snippet::prepare_execution()
 {
-	fill(instr_evaluated.begin(), instr_evaluated.end(), false);
+	execution_number++;
+	if (execution_number == 0)
+	{
+		// the execution numbers have wrapped around, the old marks have to be cleared once
+		fill(instr_evaluated_in.begin(), instr_evaluated_in.end(), 0);
+		execution_number = 1;
+	}
 	zerodiv_excepted = false;
 }
 
-vec<int32_t> Snippet::get_execution_results()
+uint32_t Snippet::print_count() const
+{
+	return std::count_if(instructions.begin(), instructions.end(), [](const Instruction& instr){ return instr.is_print(); });
+}
+
+void Snippet::get_execution_results(int32_t* ress)
 {
-	vec<int32_t> ress;
 	for (uint32_t i = 0; i < instructions.size(); i++)
 		if (instructions[i].is_print())
 		{
 			request_eval(i);
-			ress.push_back(instr_value[i]);
+			*ress++ = instr_value[i];
 		}
-	return ress;
 }
 
 int32_t Snippet::read_write(const uint32_t action_index)
@@ -523,16 +789,93 @@ int32_t Snippet::read_write(const uint32_t action_index)
 	return instr_value[instri];
 }
 
-const vec<uint32_t>& Snippet::get_write_dependencies(const uint32_t action_index) const
+ReadSetView Snippet::get_write_dependencies(const uint32_t action_index) const
+{
+	return get_read_set(trans_read_deps[actions[action_index]]);
+}
+
+ReadSetView Snippet::get_read_set(const uint32_t id) const
 {
-	return trans_read_deps[actions[action_index]];
+	return { read_set_data.data() + read_set_offsets[id], read_set_data.data() + read_set_offsets[id + 1] };
+}
+
+vec<uint32_t> Snippet::get_output_dependencies() const
+{
+	vec<uint32_t> res;
+	for (uint32_t i = 0; i < instructions.size(); i++)
+		if (instructions[i].is_print())
+		{
+			const ReadSetView deps = get_read_set(trans_read_deps[i]);
+			res.insert(res.end(), deps.begin(), deps.end());
+		}
+	std::sort(res.begin(), res.end());
+	res.erase(std::unique(res.begin(), res.end()), res.end());
+	return res;
+}
+
+bool Snippet::may_write_throw(const uint32_t action_index) const
+{
+	assert(instructions[actions[action_index]].is_write());
+	return trans_may_throw[actions[action_index]];
+}
+
+bool Snippet::may_throw() const
+{
+	return std::find(trans_may_throw.begin(), trans_may_throw.end(), true) != trans_may_throw.end();
+}
+
+void Snippet::invalidate_read_dependents(const uint32_t action_index)
+{
+	for (const uint32_t instri : read_dependents[action_index])
+		instr_evaluated_in[instri] = execution_number - 1;
+}
+
+vec<DataflowInstruction> Snippet::get_dataflow() const
+{
+	vec<DataflowInstruction> res(instructions.size());
+	uint32_t nact = 0;
+	for (uint32_t i = 0; i < instructions.size(); i++)
+	{
+		const Instruction& instr = instructions[i];
+		DataflowInstruction& di = res[i];
+		di = { DataflowInstruction::Kind::NoValue, ArithmeticOpType::Add, { -1, -1 }, { 0, 0 }, -1, instr.is_print() };
+		if (nact < actions.size() && actions[nact] == i)
+			di.action_index = nact++;
+
+		// fills in the operand at position opi from the LocalValue val (nex counts the non-literal operands, which are the ones that have an entry in argument_deps)
+		uint32_t nex = 0;
+		const auto set_operand = [&](const uint32_t opi, const LocalValue& val)
+		{
+			if (val.is_literal())
+				di.literal[opi] = val.get_literal();
+			else
+				di.source[opi] = argument_deps[i][nex++];
+		};
+
+		if (instr.is_arithmetic())
+		{
+			const ArithmeticInstruction& ari = instr.as_arithmetic();
+			di.kind = DataflowInstruction::Kind::Arithmetic;
+			di.op_type = ari.op_type;
+			set_operand(0, ari.op0);
+			set_operand(1, ari.op1);
+		}
+		else if (instr.is_write() || instr.is_move() || instr.is_print())
+		{
+			di.kind = DataflowInstruction::Kind::Copy;
+			set_operand(0, instr.is_write() ? instr.get_write_data() : instr.is_move() ? instr.as_move().data : instr.get_print_arg());
+		}
+		else if (instr.is_read())
+			di.kind = DataflowInstruction::Kind::Read;
+	}
+	return res;
 }
 
 void Snippet::supply_read_value(const uint32_t action_index, const int32_t value)
 {
 	const uint32_t instri = actions[action_index];
 	assert(instructions[instri].is_read());
-	instr_evaluated[instri] = true;
+	instr_evaluated_in[instri] = execution_number;
 	instr_value[instri] = value;
 }
 
@@ -1,6 +1,7 @@
 #ifndef SNIPPET_HPP
 #define SNIPPET_HPP
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
@@ -161,6 +162,47 @@ struct Instruction
 	const LocalValue& get_print_arg() const;
 };
 
+/// One instruction of a snippet in the flat form used for evaluating many executions at once; the value of the instruction is computed only from literals,
+/// from the values of other instructions of the same snippet and, for reads, from the value supplied to the read
+struct DataflowInstruction
+{
+	enum class Kind
+	{
+		NoValue, Read, Copy, Arithmetic
+	};
+
+	/// How the value is computed: not at all (locks and unlocks), supplied from outside, copied from the first operand or computed by an arithmetic operation
+	Kind kind;
+
+	/// Operation type (only used by Kind::Arithmetic)
+	ArithmeticOpType op_type;
+
+	/// For each operand, the index of the instruction producing its value or -1 if the operand has the value stored in literal
+	int32_t source[2];
+
+	/// For each operand whose source is -1, its value (zero for a local variable that has never been written to)
+	int32_t literal[2];
+
+	/// Action index of the instruction or -1 if it isn't an action
+	int32_t action_index;
+
+	/// True iff the instruction is a print
+	bool is_print;
+};
+
+/// Read-only view of a sorted set of action indices of reads kept by a Snippet (valid as long as the Snippet isn't changed or destroyed)
+struct ReadSetView
+{
+	/// The first element and the end of the elements
+	const uint32_t* first;
+	const uint32_t* last;
+
+	const uint32_t* begin() const;
+	const uint32_t* end() const;
+	uint32_t size() const;
+	bool empty() const;
+};
+
 class Snippet
 {
 public:
@@ -179,6 +221,11 @@ public:
 
 	/// Prints the instructions of this snippet using a set of predefined mnemonics; one instruction per line
 	void print(std::ostream& os) const;
+	/// Prints the instructions like print does, but with the local variables renamed in the order of their first use, all other names replaced by rename_global, and every instruction
+	/// that can cause an exception prefixed by its line number, renumbered in the order of first appearance (line_map[k] is set to the original line number of the renumbered line k + 1)
+	void print_canonical(std::ostream& os, const std::function<Ident(const Ident&)>& rename_global, vec<uint32_t>& line_map) const;
+	/// Returns the names of all shared variables, volatile variables and monitors used by this snippet in the order of their first use
+	vec<Ident> get_global_names() const;
 
 	/// Returns the number of instructions in this snippet which are JMM actions
 	size_t action_count() const;
@@ -192,16 +239,32 @@ public:
 
 	const str& get_name() const;
 
+	/// Simplifies the instructions without changing the actions or the possible execution results (folds constants, propagates copies, merges identical subexpressions
+	/// and removes the computations that reach no print or write); can be run once after the parse has finished emitting instructions and before run_preexecution_analysis
+	void optimize();
 	/// Should be run exactly once after the parse has finished emitting instructions and before any execution starts or dependencies are requested (computes dependencies between instructions etc.)
 	void run_preexecution_analysis();
 	/// Should be run (at least) once before the start of every new execution (clears the program state)
 	void prepare_execution();
-	/// Assuming the value for all reads has already been supplied, returns the value printed out by every print call. The order of the values is the same as of the print statements in the source code
-	vec<int32_t> get_execution_results();
+	/// Returns the number of print statements of this snippet
+	uint32_t print_count() const;
+	/// Assuming the value for all reads has already been supplied, stores the value printed out by every print call into ress[0], ress[1], ... (print_count values).
+	/// The order of the values is the same as of the print statements in the source code
+	void get_execution_results(int32_t* ress);
 	/// Assuming the value for all reads it depends on has already been supplied, returns the value written by the write which is the action_index-th (zero-based) action
 	int32_t read_write(uint32_t action_index);
-	/// Returns a vector of action indices which are of the reads that the write with action index action_index depends on
-	const vec<uint32_t>& get_write_dependencies(uint32_t action_index) const;
+	/// Returns the action indices of the reads that the write with action index action_index depends on (sorted in increasing order)
+	ReadSetView get_write_dependencies(uint32_t action_index) const;
+	/// Returns the action indices of all reads that the value of some print depends on (sorted in increasing order)
+	vec<uint32_t> get_output_dependencies() const;
+	/// Returns true if and only if evaluating the write with action index action_index can cause a division by zero exception (for some values of the reads it depends on)
+	bool may_write_throw(uint32_t action_index) const;
+	/// Returns true if and only if some instruction of this snippet can cause a division by zero exception
+	bool may_throw() const;
+	/// Marks all instructions that depend on the read with action index action_index as not evaluated in the current execution (so that a new value can be supplied to the read)
+	void invalidate_read_dependents(uint32_t action_index);
+	/// Returns the instructions in the form of DataflowInstruction (in the same order; can only be used after run_preexecution_analysis)
+	vec<DataflowInstruction> get_dataflow() const;
 	/// Saves what the value to be read by the read at action index action_index should be
 	void supply_read_value(uint32_t action_index, int32_t value);
 	/// Returns true if and only if some instruction in the current execution caused a division by zero exception; if that was the case, the execution shouldn't be continued
@@ -225,6 +288,9 @@ private:
 	// creates a new compiler temporary variable and returns its index as a local variable
 	size_t allocate_temporary();
 
+	// prints the instructions using local_name and global_name to name the variables and monitors and writing line_prefix(instruction) before each instruction
+	void print_instructions(std::ostream& os, const std::function<str(size_t)>& local_name, const std::function<Ident(const Ident&)>& global_name, const std::function<str(const Instruction&)>& line_prefix) const;
+
 	// should be called whenever the last instruction is a JMM action and so it should be added to the list of actions
 	void pushed_action();
 	
@@ -237,11 +303,33 @@ private:
 	// for each instruction, for each LocalValue input that is a local variable (and not a constant literal), stores the index of the instruction that produces the value that should be read there -- if the default zero initialization should be read, stores a -1
 	vec<vec<int32_t>> argument_deps;
 
-	// for each instruction, stores the list of all read instruction indices that the instruction (even transitively) depends on
-	vec<vec<uint32_t>> trans_read_deps;
+	// for each instruction, stores the id of the set of the action indices of all the reads that the instruction (even transitively) depends on
+	// (the instructions that depend on the same reads share the set, so copying the dependencies of an operand is constant time)
+	vec<uint32_t> trans_read_deps;
+
+	// the distinct sets of trans_read_deps stored one after another, each one sorted: set k consists of the elements from read_set_offsets[k]
+	// to read_set_offsets[k + 1] of read_set_data (set 0 is the empty set)
+	vec<uint32_t> read_set_data;
+	vec<uint32_t> read_set_offsets;
+
+	// returns the set of reads with the given id
+	ReadSetView get_read_set(uint32_t id) const;
+
+	// for each action index of a read, the indices of all instructions that (even transitively) depend on it
+	vec<vec<uint32_t>> read_dependents;
+
+	// for each instruction, stores true iff evaluating the instruction can cause a division by zero exception (even in an instruction it transitively depends on)
+	vec<bool> trans_may_throw;
+
+	// for each instruction, stores the number of the execution in which the instruction has been evaluated (it has been evaluated in the current execution iff this equals execution_number)
+	vec<uint32_t> instr_evaluated_in;
+
+	// number of the current execution, increased by prepare_execution (so that the evaluated instructions don't have to be cleared)
+	uint32_t execution_number = 0;
 
-	// for each instruction, stores true iff the instruction has already been evaluated
-	vec<bool> instr_evaluated;
+	// stack used by request_eval (kept to reuse its memory); in each pair, the first element is the instruction index and
+	// the second element is the next index in the instruction's argument dependencies that should be visited
+	vec<std::pair<uint32_t, uint32_t>> eval_stack;
 
 	// for each instruction, stores the value that it produced assuming that it has already be evaluated
 	vec<int32_t> instr_value;
@@ -0,0 +1,66 @@
+#include "source-file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace JMMExplorer
+{
+
+SourceFile::~SourceFile()
+{
+	close();
+}
+
+bool SourceFile::open(const str& path)
+{
+	close();
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			size = st.st_size;
+			::close(fd);
+			return true;
+		}
+		data = nullptr;
+	}
+
+	// files that can't be mapped (pipes etc.) are read into a buffer instead
+	bool ok = true;
+	char buffer[1 << 16];
+	while (true)
+	{
+		const ssize_t count = read(fd, buffer, sizeof(buffer));
+		if (count <= 0)
+		{
+			ok = count == 0;
+			break;
+		}
+		contents.append(buffer, count);
+	}
+	::close(fd);
+	return ok;
+}
+
+std::string_view SourceFile::get_text() const
+{
+	return data ? std::string_view(static_cast<const char*>(data), size) : std::string_view(contents);
+}
+
+void SourceFile::close()
+{
+	if (data)
+		munmap(data, size);
+	data = nullptr;
+	size = 0;
+	contents.clear();
+}
+
+}
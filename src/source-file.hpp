@@ -0,0 +1,40 @@
+#ifndef SOURCE_FILE_HPP
+#define SOURCE_FILE_HPP
+
+#include <cstddef>
+#include <string_view>
+
+#include "str.hpp"
+
+namespace JMMExplorer
+{
+
+/// Contents of a source file loaded into memory; regular files are memory-mapped, so that even large files are available without being copied
+class SourceFile
+{
+public:
+	SourceFile() = default;
+	SourceFile(const SourceFile&) = delete;
+	SourceFile& operator=(const SourceFile&) = delete;
+	~SourceFile();
+
+	/// Loads the file at path (replacing the previously loaded file); returns false if the file can't be opened or read
+	bool open(const str& path);
+	/// Returns the contents of the loaded file (empty if no file is loaded); valid as long as this SourceFile exists and no other file is opened
+	std::string_view get_text() const;
+
+private:
+	// start of the mapped contents (nullptr if none are mapped) and their size
+	void *data = nullptr;
+	size_t size = 0;
+
+	// contents of a file that couldn't be mapped
+	str contents;
+
+	// unmaps the contents of the current file
+	void close();
+};
+
+}
+
+#endif // SOURCE_FILE_HPP
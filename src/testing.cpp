@@ -1,15 +1,26 @@
 #include "testing.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <sstream>
+#include <unordered_set>
 #include <variant>
 
 #include "analysis.hpp"
+#include "canonical.hpp"
+#include "parallel.hpp"
+#include "snippet.hpp"
 
 namespace JMMExplorer
 {
 
+/// Default limit of the wall time of the analysis of one TestCase in milliseconds (generous, since the cases run concurrently)
+constexpr uint32_t default_max_millis = 5000;
+
+/// Default limit of the number of write-seen candidates evaluated by the analysis of one TestCase
+constexpr uint64_t default_max_candidates = 1000000;
+
 struct TestCase
 {
 	/// true iff our program is expected not only to produce a set of legals outputs, but to also produce the complete set of all legal results
@@ -20,8 +31,217 @@ struct TestCase
 	
 	/// all possible execution results allowed by the JMM -- should be precomputed by hand, so that we can check against this
 	vec<ExecutionResult> results;
+
+	/// the case fails if its analysis takes longer than this many milliseconds of wall time
+	uint32_t max_millis = default_max_millis;
+
+	/// the case fails if its analysis evaluates more write-seen candidates than this
+	uint64_t max_candidates = default_max_candidates;
+};
+
+/// Hash of an execution result, so that sets of execution results can be compared without pairwise scans
+struct ExecutionResultHash
+{
+	size_t operator()(const ExecutionResult& res) const
+	{
+		if (std::holds_alternative<ExceptedExecutionResult>(res.result))
+		{
+			const ExceptedExecutionResult& eres = std::get<ExceptedExecutionResult>(res.result);
+			return ~((static_cast<size_t>(eres.ex_thread) << 32) ^ eres.ex_line);
+		}
+		size_t h = 0;
+		for (const vec<int32_t>& thread_output : std::get<RegularExecutionResult>(res.result))
+		{
+			h = h * 31 + thread_output.size();
+			for (const int32_t value : thread_output)
+				h = h * 1000003 + static_cast<uint32_t>(value);
+		}
+		return h;
+	}
 };
 
+typedef std::unordered_set<ExecutionResult, ExecutionResultHash> ExecutionResultSet;
+
+struct CanonicalizationTestCase
+{
+	/// true iff the two programs are expected to be equal up to renaming and thread order
+	bool equivalent;
+
+	/// each entry of these vectors is the source code for one thread of the first and of the second program
+	vec<std::string> sources0, sources1;
+};
+
+/// Parses and analyzes the program made of the given sources, returns the canonical form and the execution results translated to the canonical program
+static CanonicalProgram analyze_canonical(const vec<std::string>& sources, vec<ExecutionResult>& canonical_results)
+{
+	vec<std::string> filenames;
+	vec<std::unique_ptr<std::stringstream>> uq_inputs;
+	vec<std::istream*> inputs;
+	for (uint32_t j = 0; j < sources.size(); j++)
+	{
+		filenames.push_back("thread " + std::to_string(j));
+		uq_inputs.push_back(std::make_unique<std::stringstream>(sources[j]));
+		inputs.push_back(uq_inputs.back().get());
+	}
+	vec<Snippet> snps;
+	parse_snippets(filenames, inputs, snps);
+	const CanonicalProgram can = canonicalize(snps);
+
+	for (const auto& input : uq_inputs)
+	{
+		input->clear();
+		input->seekg(0);
+	}
+	vec<ExecutionResult> results;
+	analyze(filenames, inputs, results, std::cerr);
+	for (const ExecutionResult& res : results)
+		canonical_results.push_back(can.to_canonical(res));
+	return can;
+}
+
+/// Runs the tests of the canonicalization of programs and returns the number of failed cases
+static uint32_t run_canonicalization_tests()
+{
+	const vec<CanonicalizationTestCase> tcases = {
+		// 0
+		CanonicalizationTestCase{ true, { "print(sx);", "sx=1;" }, { "sa=1;", "print(sa);" } },
+		// 1
+		CanonicalizationTestCase{ true, { "m.lock();print(sx);sy=1;m.unlock();", "m.lock();print(sy);sx=1;m.unlock();" }, { "mo.lock();print(sb);sa=1;mo.unlock();", "mo.lock();print(sa);sb=1;mo.unlock();" } },
+		// 2
+		CanonicalizationTestCase{ true, { "l=1;\nprint(1/sx);", "sx=1;" }, { "sq=1;", "local=1;print(1/sq);" } },
+		// 3
+		CanonicalizationTestCase{ true, { "print(v0/v1);", "v0+=563;v1+=7;" }, { "vb+=563;vx+=7;", "print(vb/vx);" } },
+		// 4
+		CanonicalizationTestCase{ false, { "print(sx);", "sy=1;" }, { "print(sx);", "sx=1;" } },
+		// 5
+		CanonicalizationTestCase{ false, { "print(sx);", "vx=1;" }, { "print(sx);", "sx=1;" } }
+	};
+
+	uint32_t failed_count = 0;
+	for (uint32_t i = 0; i < tcases.size(); i++)
+	{
+		const CanonicalizationTestCase& tcase = tcases[i];
+		std::cout << "[[ CANONICALIZATION TEST CASE " << i << " ]]" << std::endl;
+		vec<ExecutionResult> results0, results1;
+		const CanonicalProgram can0 = analyze_canonical(tcase.sources0, results0);
+		const CanonicalProgram can1 = analyze_canonical(tcase.sources1, results1);
+		bool wrong = false;
+		if ((can0.key == can1.key) != tcase.equivalent)
+		{
+			wrong = true;
+			std::cout << "the canonical forms " << (tcase.equivalent ? "differ" : "are equal") << std::endl;
+		}
+		else if (tcase.equivalent)
+		{
+			const auto contains_all = [](const vec<ExecutionResult>& ress, const vec<ExecutionResult>& others)
+			{
+				return std::all_of(ress.begin(), ress.end(), [&others](const ExecutionResult& res){ return std::find(others.begin(), others.end(), res) != others.end(); });
+			};
+			if (!contains_all(results0, results1) || !contains_all(results1, results0))
+			{
+				wrong = true;
+				std::cout << "the translated execution results differ" << std::endl;
+			}
+		}
+		failed_count += wrong;
+	}
+	std::cout << "RUN " << tcases.size() << " CANONICALIZATION TEST CASES\n";
+	return failed_count;
+}
+
+/// Runs the tests of analyzing a parsed Program repeatedly and of stopping its analysis early; returns the number of failed checks
+static uint32_t run_program_api_tests()
+{
+	const vec<std::string> filenames = { "thread 0", "thread 1", "thread 2" };
+	const vec<std::string_view> sources = { "print(sx);print(sy);", "sx=1;", "sy=1;" };
+	Program program;
+	uint32_t failed_count = 0;
+	const auto check = [&failed_count](const bool ok, const char *const what)
+	{
+		if (!ok)
+		{
+			failed_count++;
+			std::cout << what << std::endl;
+		}
+	};
+
+	check(!program.parse(filenames, sources, std::cerr), "the program could not be parsed");
+	check(program.get_thread_count() == 3 && program.get_thread_name(1) == "thread 1", "the threads of the program are wrong");
+
+	vec<ExecutionResult> results0, results1;
+	const AnalysisStatus status0 = program.analyze([&results0](const ExecutionResult& res){ results0.push_back(res); return true; });
+	const AnalysisStatus status1 = program.analyze([&results1](const ExecutionResult& res){ results1.push_back(res); return true; });
+	check(status0 == AnalysisStatus::Completed && status1 == AnalysisStatus::Completed, "a full analysis did not complete");
+	check(results0.size() == 4 && results0 == results1, "analyzing the same program twice gave different results");
+
+	// without synchronization actions, there is a single synchronization order, so the candidates can be counted exactly
+	const AnalysisEstimate estimate = program.estimate();
+	check(estimate.so_count == 1 && estimate.well_locked_so_count == estimate.sampled_so_count && estimate.candidate_count == program.get_candidate_count(),
+		"the estimate of the size of the analysis is wrong");
+
+	// with almost no memory for the results, every result is spilled to its own temporary file and they are merged at the end
+	vec<ExecutionResult> spilled_results;
+	AnalysisOptions spill_options;
+	spill_options.result_memory_limit = 1;
+	const AnalysisStatus spill_status = program.analyze([&spilled_results](const ExecutionResult& res){ spilled_results.push_back(res); return true; }, spill_options);
+	check(spill_status == AnalysisStatus::Completed && spilled_results.size() == results0.size()
+		&& std::is_permutation(spilled_results.begin(), spilled_results.end(), results0.begin()), "spilling the results to files changed them");
+
+	vec<ExecutionResult> budget_results;
+	const AnalysisStatus budget_status = program.analyze([&budget_results](const ExecutionResult& res){ budget_results.push_back(res); return true; }, AnalysisOptions{ 1 });
+	check(budget_status == AnalysisStatus::BudgetExhausted, "the analysis did not stop at the candidate budget");
+	check(budget_results.size() < results0.size() && std::all_of(budget_results.begin(), budget_results.end(),
+		[&results0](const ExecutionResult& res){ return std::find(results0.begin(), results0.end(), res) != results0.end(); }), "the analysis with a candidate budget gave wrong results");
+
+	AnalysisOptions tiny_memory_options;
+	tiny_memory_options.memory_limit = 1;
+	check(program.analyze(ResultSink(), tiny_memory_options) == AnalysisStatus::MemoryExhausted, "the analysis did not stop at the memory limit");
+
+	uint32_t sunk_count = 0;
+	const AnalysisStatus cancel_status = program.analyze([&sunk_count](const ExecutionResult&){ sunk_count++; return false; });
+	check(cancel_status == AnalysisStatus::Cancelled && sunk_count == 1, "the analysis did not stop when the sink asked for it");
+
+	// a program without synchronization actions has a single synchronization order, whose 4^8 candidates are split among the threads
+	Program many_candidates;
+	check(!many_candidates.parse({ "thread 0", "thread 1" }, { "print(sa);print(sb);print(sc);print(sd);print(se);print(sf);print(sg);print(sh);",
+		"sa=1;sb=1;sc=1;sd=1;se=1;sf=1;sg=1;sh=1;sa=2;sb=2;sc=2;sd=2;se=2;sf=2;sg=2;sh=2;sa=3;sb=3;sc=3;sd=3;se=3;sf=3;sg=3;sh=3;" }, std::cerr),
+		"the program with many candidates could not be parsed");
+	ExecutionResultSet sequential_results, parallel_results;
+	AnalysisOptions sequential_options, parallel_options;
+	sequential_options.worker_count = 1;
+	parallel_options.worker_count = 4;
+	many_candidates.analyze([&sequential_results](const ExecutionResult& res){ sequential_results.insert(res); return true; }, sequential_options);
+	const uint64_t sequential_candidate_count = many_candidates.get_candidate_count();
+	const AnalysisStatus parallel_status = many_candidates.analyze([&parallel_results](const ExecutionResult& res){ return parallel_results.insert(res).second; }, parallel_options);
+	check(parallel_status == AnalysisStatus::Completed && sequential_results.size() == 65536 && parallel_results == sequential_results
+		&& many_candidates.get_candidate_count() == sequential_candidate_count, "evaluating the candidates of a synchronization order in parallel changed the results");
+	parallel_options.candidate_budget = 1000;
+	check(many_candidates.analyze(ResultSink(), parallel_options) == AnalysisStatus::BudgetExhausted && many_candidates.get_candidate_count() == 1000,
+		"the parallel evaluation of the candidates did not stop at the candidate budget");
+
+	// the store buffering litmus test: both threads printing 0 is allowed by the JMM, but not by sequential consistency
+	Program store_buffering;
+	check(!store_buffering.parse({ "thread 0", "thread 1" }, { "sx=1;print(sy);", "sy=1;print(sx);" }, std::cerr), "the store buffering program could not be parsed");
+	vec<ExecutionResult> sc_results;
+	AnalysisOptions sc_options;
+	sc_options.sequential_consistency = true;
+	const AnalysisStatus sc_status = store_buffering.analyze([&sc_results](const ExecutionResult& res){ sc_results.push_back(res); return true; }, sc_options);
+	const ExecutionResult both_zero{ RegularExecutionResult{ { 0 }, { 0 } } };
+	check(sc_status == AnalysisStatus::Completed && sc_results.size() == 3 && std::find(sc_results.begin(), sc_results.end(), both_zero) == sc_results.end(),
+		"the sequentially consistent results of the store buffering program are wrong");
+
+	// the results fit into the limit, but the visited states don't, so they are forgotten and explored again
+	vec<ExecutionResult> forgetful_results;
+	sc_options.memory_limit = 512;
+	const AnalysisStatus forgetful_status = store_buffering.analyze([&forgetful_results](const ExecutionResult& res){ forgetful_results.push_back(res); return true; }, sc_options);
+	check(forgetful_status == AnalysisStatus::Completed && forgetful_results == sc_results, "forgetting the visited states changed the sequentially consistent results");
+	sc_options.memory_limit = 1;
+	check(store_buffering.analyze(ResultSink(), sc_options) == AnalysisStatus::MemoryExhausted, "the sequentially consistent analysis did not stop at the memory limit");
+
+	std::cout << "RUN PROGRAM API TESTS\n";
+	return failed_count;
+}
+
 void run_all_tests()
 {
 	const vec<TestCase> tcases = {
@@ -115,7 +335,7 @@ void run_all_tests()
 			{ RegularExecutionResult{ { 6 }, { 4 } } },
 			{ RegularExecutionResult{ { 6 }, { 5 } } },
 			{ RegularExecutionResult{ { 6 }, { 6 } } }
-		} },
+		}, 1000, 65536 },
 		// 10
 		TestCase{ true, { "vcounter++;vcounter++;vcounter++;print(vcounter);", "vcounter++;vcounter++;vcounter++;print(vcounter);" }, {
 			{ RegularExecutionResult{ { 1 }, { 3 } } },
@@ -251,7 +471,42 @@ void run_all_tests()
 			{ RegularExecutionResult{ { 0 }, { } } },
 			{ RegularExecutionResult{ { 80 }, { } } },
 			{ ExceptedExecutionResult{ 0, 1 } }
-		} }
+		} },
+		// 26 (the critical sections are enumerated as whole units, otherwise there would be hundreds of millions of synchronization orders)
+		TestCase{ true, { "m.lock();v++;m.unlock();m.lock();l=v;m.unlock();print(l);", "m.lock();v++;m.unlock();m.lock();l=v;m.unlock();print(l);", "m.lock();v++;m.unlock();m.lock();l=v;m.unlock();print(l);" }, {
+			{ RegularExecutionResult{ { 1 }, { 2 }, { 3 } } },
+			{ RegularExecutionResult{ { 1 }, { 3 }, { 2 } } },
+			{ RegularExecutionResult{ { 1 }, { 3 }, { 3 } } },
+			{ RegularExecutionResult{ { 2 }, { 1 }, { 3 } } },
+			{ RegularExecutionResult{ { 2 }, { 2 }, { 3 } } },
+			{ RegularExecutionResult{ { 2 }, { 3 }, { 1 } } },
+			{ RegularExecutionResult{ { 2 }, { 3 }, { 2 } } },
+			{ RegularExecutionResult{ { 2 }, { 3 }, { 3 } } },
+			{ RegularExecutionResult{ { 3 }, { 1 }, { 2 } } },
+			{ RegularExecutionResult{ { 3 }, { 1 }, { 3 } } },
+			{ RegularExecutionResult{ { 3 }, { 2 }, { 1 } } },
+			{ RegularExecutionResult{ { 3 }, { 2 }, { 2 } } },
+			{ RegularExecutionResult{ { 3 }, { 2 }, { 3 } } },
+			{ RegularExecutionResult{ { 3 }, { 3 }, { 1 } } },
+			{ RegularExecutionResult{ { 3 }, { 3 }, { 2 } } },
+			{ RegularExecutionResult{ { 3 }, { 3 }, { 3 } } }
+		}, default_max_millis, 1000 },
+		// 27 (all the synchronization actions are inert, so there is a single synchronization order)
+		TestCase{ true, { "m0.lock();v0=sx+1;m0.unlock();l1=vr;vw=0;m0.lock();l2=v0;m0.unlock();sx=l2;print(l1+l2);", "m1.lock();v1=sx+1;m1.unlock();l1=vr;vw=1;m1.lock();l2=v1;m1.unlock();sx=l2;print(l1+l2);", "m2.lock();v2=sx+1;m2.unlock();l1=vr;vw=2;m2.lock();l2=v2;m2.unlock();sx=l2;print(l1+l2);" }, {
+			{ RegularExecutionResult{ { 1 }, { 1 }, { 1 } } },
+			{ RegularExecutionResult{ { 1 }, { 1 }, { 2 } } },
+			{ RegularExecutionResult{ { 1 }, { 2 }, { 1 } } },
+			{ RegularExecutionResult{ { 1 }, { 2 }, { 2 } } },
+			{ RegularExecutionResult{ { 1 }, { 2 }, { 3 } } },
+			{ RegularExecutionResult{ { 1 }, { 3 }, { 2 } } },
+			{ RegularExecutionResult{ { 2 }, { 1 }, { 1 } } },
+			{ RegularExecutionResult{ { 2 }, { 1 }, { 2 } } },
+			{ RegularExecutionResult{ { 2 }, { 1 }, { 3 } } },
+			{ RegularExecutionResult{ { 2 }, { 2 }, { 1 } } },
+			{ RegularExecutionResult{ { 2 }, { 3 }, { 1 } } },
+			{ RegularExecutionResult{ { 3 }, { 1 }, { 2 } } },
+			{ RegularExecutionResult{ { 3 }, { 2 }, { 1 } } }
+		}, default_max_millis, 1000 }
 	};
 
 	// number of cases where our program considered the source code to be ill formed (it is never supposed to be, so this count should remain at zero if our program is correct)
@@ -260,50 +515,87 @@ void run_all_tests()
 	// number of cases where our program didn't consider the source code to be ill formed, but it produced an incorrect set of possible results
 	uint32_t wrong_answer_count = 0;
 
-	for (uint32_t i = 0; i < tcases.size(); i++)
+	// number of cases whose analysis took longer or evaluated more candidates than allowed
+	uint32_t over_budget_count = 0;
+
+	// number of cases that failed in any of the ways above
+	uint32_t failed_count = 0;
+
+	// the cases are analyzed concurrently; everything reported about a case is collected in its own stream and printed in the order of the cases
+	vec<std::ostringstream> reports(tcases.size());
+	vec<uint8_t> errored(tcases.size()), wrong(tcases.size()), over_budget(tcases.size());
+	parallel_for(tcases.size(), [&](const uint32_t i)
 	{
 		const TestCase& tcase = tcases[i];
+		std::ostringstream& report = reports[i];
 		vec<std::string> filenames;
-		vec<std::unique_ptr<std::stringstream>> uq_inputs;
-		vec<std::istream*> inputs;
 		for (uint32_t j = 0; j < tcase.sources.size(); j++)
-		{
 			filenames.push_back("thread " + std::to_string(j));
-			uq_inputs.push_back(std::make_unique<std::stringstream>(tcase.sources[j]));
-			inputs.push_back(uq_inputs.back().get());
+		report << "[[ TEST CASE " << i << " ]]" << std::endl;
+
+		const auto start = std::chrono::steady_clock::now();
+		Program program;
+		if (program.parse(filenames, vec<std::string_view>(tcase.sources.begin(), tcase.sources.end()), report))
+		{
+			errored[i] = true;
+			return;
 		}
-		std::cout << "[[ TEST CASE " << i << " ]]" << std::endl;
-		vec<ExecutionResult> results;
-		if (analyze(filenames, inputs, results, std::cerr))
+		ExecutionResultSet results;
+		AnalysisOptions options;
+		options.candidate_budget = tcase.max_candidates + 1;
+		const AnalysisStatus status = program.analyze([&results](const ExecutionResult& res){ results.insert(res); return true; }, options);
+		const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		report << "took " << millis << " ms and evaluated " << program.get_candidate_count() << " candidates" << std::endl;
+
+		if (program.get_candidate_count() > tcase.max_candidates)
 		{
-			errored_count++;
-			continue;
+			over_budget[i] = true;
+			report << "the analysis evaluated more than " << tcase.max_candidates << " candidates" << std::endl;
 		}
-		bool wrong = false;
+		if (millis > tcase.max_millis)
+		{
+			over_budget[i] = true;
+			report << "the analysis took longer than " << tcase.max_millis << " ms" << std::endl;
+		}
+
+		const ExecutionResultSet legal_results(tcase.results.begin(), tcase.results.end());
 		for (const ExecutionResult& res : results)
-			if (!std::any_of(tcase.results.begin(), tcase.results.end(), [&res](const ExecutionResult& other){ return res == other; }))
+			if (!legal_results.count(res))
 			{
-				wrong = true;
-				std::cout << "the analysis produced \"";
-				res.print(std::cout, [&filenames](const uint32_t thread_i){ return filenames[thread_i]; });
-				std::cout << "\", which is not a legal output" << std::endl;
+				wrong[i] = true;
+				report << "the analysis produced \"";
+				res.print(report, [&filenames](const uint32_t thread_i){ return filenames[thread_i]; });
+				report << "\", which is not a legal output" << std::endl;
 			}
-		if (tcase.require_all)
+		if (tcase.require_all && status == AnalysisStatus::Completed)
 			for (const ExecutionResult& res : tcase.results)
-				if (!std::any_of(results.begin(), results.end(), [&res](const ExecutionResult& other){ return res == other; }))
+				if (!results.count(res))
 				{
-					wrong = true;
-					std::cout << "the analysis missed the output \"";
-					res.print(std::cout, [&filenames](const uint32_t thread_i){ return filenames[thread_i]; });
-					std::cout << "\"" << std::endl;
+					wrong[i] = true;
+					report << "the analysis missed the output \"";
+					res.print(report, [&filenames](const uint32_t thread_i){ return filenames[thread_i]; });
+					report << "\"" << std::endl;
 				}
-		wrong_answer_count += wrong;
+	});
+	for (uint32_t i = 0; i < tcases.size(); i++)
+	{
+		std::cout << reports[i].str();
+		errored_count += errored[i];
+		wrong_answer_count += wrong[i];
+		over_budget_count += over_budget[i];
+		failed_count += errored[i] || wrong[i] || over_budget[i];
 	}
 	std::cout << "RUN " << tcases.size() << " TEST CASES\n";
-	if (!errored_count && !wrong_answer_count)
+
+	const uint32_t canonicalization_failed_count = run_canonicalization_tests();
+	const uint32_t program_api_failed_count = run_program_api_tests();
+
+	if (!failed_count && !canonicalization_failed_count && !program_api_failed_count)
 		std::cout << "ALL PASSED\n";
 	else
-   		std::cout << errored_count << " RETURNED AN ERROR\n" << wrong_answer_count << " GAVE A WRONG ANSWER\n" << tcases.size() - errored_count - wrong_answer_count << " PASSED\n";
+   		std::cout << errored_count << " RETURNED AN ERROR\n" << wrong_answer_count << " GAVE A WRONG ANSWER\n" << over_budget_count << " EXCEEDED THEIR BUDGET\n"
+			<< tcases.size() - failed_count << " PASSED\n"
+			<< canonicalization_failed_count << " CANONICALIZATION CASES FAILED\n" << program_api_failed_count << " PROGRAM API CHECKS FAILED\n";
 }
 
 }